@@ -0,0 +1,135 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "allocator.h"
+#include "sizing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fxcalc {
+	namespace {
+		// round lots down to a whole number of lot steps
+		double floorToStep( double lots, double lot_step ) {
+			// tolerance protects against 0.3 / 0.1 = 2.9999...
+			return std::floor( lots / lot_step + 1e-9 ) * lot_step;
+		}
+
+		Allocation makeAllocation( double lots, double risk_per_lot, double margin_per_lot ) {
+			Allocation allocation;
+			allocation.lots   = lots;
+			allocation.units  = lots * kContractSize;
+			allocation.risk   = lots * risk_per_lot;
+			allocation.margin = lots * margin_per_lot;
+			return allocation;
+		}
+	}
+
+	LotAllocator::LotAllocator( double free_margin, double margin_ratio ):
+		free_margin_(free_margin), margin_ratio_(margin_ratio) {}
+
+	AllocationResult LotAllocator::allocate( const std::vector<OrderRequest>& orders ) const {
+		const std::size_t count = orders.size();
+
+		AllocationResult result;
+		result.allocations.assign( count, makeAllocation( 0, 0, 0 ) );
+		result.total_risk   = 0;
+		result.total_margin = 0;
+		result.risk_bound   = 0;
+
+		std::vector<double> risk_per_lot( count, 0 );
+		std::vector<double> margin_per_lot( count, 0 );
+		std::vector<double> capacity( count, 0 );  // fractional lots at target risk
+		std::vector<double> rounded( count, 0 );   // capacity rounded to broker steps
+
+		// orders that can't be sized stay at 0 lots and out of the ordering
+		std::vector<std::size_t> index;
+		index.reserve( count );
+
+		double margin_needed = 0;
+		for ( std::size_t i = 0; i < count; ++i ) {
+			const OrderRequest& order = orders[i];
+			if ( order.sl_pips <= 0 || order.unit_costs <= 0 || order.target_risk <= 0 || order.lot_step <= 0 ) continue;
+			if ( margin_ratio_ > 0 && order.margin_price <= 0 ) continue;
+			index.push_back( i );
+
+			risk_per_lot[i] = order.sl_pips * order.unit_costs * kContractSize;
+			// without a margin ratio margin is not a constraint
+			if ( margin_ratio_ > 0 ) {
+				margin_per_lot[i] = marginForUnits( kContractSize, order.margin_price, margin_ratio_ );
+			}
+
+			capacity[i] = order.target_risk / risk_per_lot[i];
+			if ( order.max_lot > 0 ) {
+				capacity[i] = std::min( capacity[i], order.max_lot );
+			}
+
+			// capacity is clamped first, so rounding stays on a lot step
+			rounded[i] = floorToStep( capacity[i], order.lot_step );
+			if ( rounded[i] < order.min_lot ) {
+				rounded[i] = 0;
+			}
+			margin_needed += rounded[i] * margin_per_lot[i];
+		}
+
+		// order by risk per margin, orders without margin come first. All
+		// risk_per_lot are positive here, which keeps the ordering strict weak.
+		std::stable_sort( index.begin(), index.end(), [&]( std::size_t a, std::size_t b ) {
+			return risk_per_lot[a] * margin_per_lot[b] > risk_per_lot[b] * margin_per_lot[a];
+		});
+
+		// upper bound: fill fractional lots until free margin is used up
+		double remaining = free_margin_;
+		for ( std::size_t k = 0; k < index.size(); ++k ) {
+			std::size_t i = index[k];
+			double lots = capacity[i];
+			if ( margin_per_lot[i] > 0 ) {
+				lots = std::min( lots, std::max( remaining, 0.0 ) / margin_per_lot[i] );
+			}
+			remaining -= lots * margin_per_lot[i];
+			result.risk_bound += lots * risk_per_lot[i];
+		}
+
+		if ( margin_needed <= free_margin_ ) {
+			// every order fits at its rounded target
+			for ( std::size_t i = 0; i < count; ++i ) {
+				result.allocations[i] = makeAllocation( rounded[i], risk_per_lot[i], margin_per_lot[i] );
+			}
+		} else {
+			// greedy fill in broker steps, the loss against risk_bound is at
+			// most one lot step or min lot per order that runs out of margin
+			remaining = free_margin_;
+			for ( std::size_t k = 0; k < index.size(); ++k ) {
+				std::size_t i = index[k];
+				double lots = rounded[i];
+				if ( margin_per_lot[i] > 0 && lots * margin_per_lot[i] > remaining ) {
+					double fit = std::max( remaining, 0.0 ) / margin_per_lot[i];
+					lots = floorToStep( fit, orders[i].lot_step );
+					if ( lots < orders[i].min_lot ) {
+						lots = 0;
+					}
+				}
+				remaining -= lots * margin_per_lot[i];
+				result.allocations[i] = makeAllocation( lots, risk_per_lot[i], margin_per_lot[i] );
+			}
+		}
+
+		for ( std::size_t i = 0; i < count; ++i ) {
+			result.total_risk   += result.allocations[i].risk;
+			result.total_margin += result.allocations[i].margin;
+		}
+
+		return result;
+	}
+};
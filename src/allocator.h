@@ -0,0 +1,65 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+namespace fxcalc {
+	// a candidate order of a basket
+	struct OrderRequest {
+		double target_risk;   // money to risk in account currency
+		double sl_pips;       // stop loss in pips
+		double unit_costs;    // pip value of one unit in account currency
+		double margin_price;  // current ask of base/account currency
+		double min_lot;       // smallest tradeable size
+		double lot_step;      // broker lot increment
+		double max_lot;       // largest tradeable size, 0 for no limit
+	};
+
+	struct Allocation {
+		double lots;
+		double units;
+		double risk;
+		double margin;
+	};
+
+	struct AllocationResult {
+		std::vector<Allocation> allocations; // same order as the requests
+		double total_risk;
+		double total_margin;
+		// risk of the fractional lot optimum, no rounded allocation exceeds
+		// it beyond floating point rounding
+		double risk_bound;
+	};
+
+	/**
+	 * Allocates broker conform lot sizes for a basket of orders.
+	 * No order exceeds its target risk and the sum of required margin
+	 * stays within the free margin. If the margin doesn't suffice, orders
+	 * with the most risk per margin are filled first. Orders without a
+	 * positive stop, pip value, target risk or lot step get 0 lots, as do
+	 * orders without a positive margin price if margin is a constraint.
+	 */
+	class LotAllocator {
+	public:
+		LotAllocator( double free_margin, double margin_ratio );
+
+		AllocationResult allocate( const std::vector<OrderRequest>& orders ) const;
+
+	private:
+		double free_margin_;
+		double margin_ratio_;
+	};
+};
@@ -0,0 +1,93 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "barfeed.h"
+
+#include <QList>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+
+namespace fxcalc {
+	BarFeed::BarFeed(QObject* parent): QObject(parent) {
+		connect( &watcher_, &QFileSystemWatcher::fileChanged, this, &BarFeed::readFile );
+		connect( &socket_, &QTcpSocket::readyRead, this, &BarFeed::readSocket );
+		connect( &socket_, static_cast<void (QTcpSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error), this, [this]() {
+			emit error( tr("Bar feed: %1").arg( socket_.errorString() ) );
+		});
+	}
+
+	void BarFeed::open( const QString& source ) {
+		close();
+		if ( source.isEmpty() ) return;
+
+		// host:port connects to a local feed, everything else is a file
+		QRegularExpression re("^(?<host>[^:/\\\\]+):(?<port>\\d+)$");
+		QRegularExpressionMatch match = re.match( source );
+		if ( match.hasMatch() ) {
+			socket_.connectToHost( match.captured("host"), match.captured("port").toUShort() );
+			return;
+		}
+
+		file_.setFileName( source );
+		if ( ! file_.open( QIODevice::ReadOnly ) ) {
+			emit error( tr("Bar feed: couldn't open %1").arg( source ) );
+			return;
+		}
+		watcher_.addPath( source );
+		readFile();
+	}
+
+	void BarFeed::close() {
+		if ( ! watcher_.files().isEmpty() ) {
+			watcher_.removePaths( watcher_.files() );
+		}
+		file_.close();
+		pending_line_.clear();
+		socket_.abort();
+	}
+
+	void BarFeed::readFile() {
+		// a partially written line is completed on the next change
+		while ( ! file_.atEnd() ) {
+			pending_line_.append( file_.readLine() );
+			if ( ! pending_line_.endsWith('\n') ) break;
+			parseLine( pending_line_ );
+			pending_line_.clear();
+		}
+	}
+
+	void BarFeed::readSocket() {
+		while ( socket_.canReadLine() ) {
+			parseLine( socket_.readLine() );
+		}
+	}
+
+	void BarFeed::parseLine( const QByteArray& line ) {
+		QList<QByteArray> fields = line.trimmed().split(',');
+		// skip optional time column
+		if ( fields.size() == 6 ) {
+			fields.removeFirst();
+		}
+		if ( fields.size() != 5 ) return;
+
+		bool ok_high(false), ok_low(false), ok_close(false);
+		double high  = fields[2].toDouble( &ok_high );
+		double low   = fields[3].toDouble( &ok_low );
+		double close = fields[4].toDouble( &ok_close );
+		// header line or broken bar
+		if ( ! ok_high || ! ok_low || ! ok_close ) return;
+
+		emit barReceived( QString::fromLatin1( fields[0] ), high, low, close );
+	}
+};
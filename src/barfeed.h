@@ -0,0 +1,56 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QTcpSocket>
+
+namespace fxcalc {
+	/**
+	 * Reads OHLC bars from a csv file or a local tcp feed.
+	 * One bar per line: [time,]instrument,open,high,low,close
+	 * A file is read completely and followed for appended lines, a source
+	 * of the form host:port is read from a tcp socket.
+	 */
+	class BarFeed: public QObject {
+		Q_OBJECT
+
+	public:
+		BarFeed(QObject* parent = 0);
+
+		void open( const QString& source );
+		void close();
+
+	signals:
+		void barReceived( const QString& instrument, double high, double low, double close );
+		void error( const QString& message );
+
+	private slots:
+		void readFile();
+		void readSocket();
+
+	private:
+		void parseLine( const QByteArray& line );
+
+		QFile file_;
+		QByteArray pending_line_;
+		QFileSystemWatcher watcher_;
+		QTcpSocket socket_;
+	};
+};
@@ -0,0 +1,171 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "correlation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fxcalc {
+	namespace {
+		// columns per block, a block of the new and the oldest row stays in L1
+		const std::size_t kBlockSize = 256;
+	}
+
+	CorrelationMatrix::CorrelationMatrix( std::size_t period ):
+		size_(0), period_( std::max<std::size_t>( period, 2 ) ), head_(0), count_(0), row_empty_(true) {}
+
+	void CorrelationMatrix::resize( std::size_t instruments ) {
+		size_  = instruments;
+		head_  = 0;
+		count_ = 0;
+		returns_.assign( period_ * size_, 0 );
+		sum_.assign( size_, 0 );
+		cross_.assign( size_ * size_, 0 );
+		last_close_.assign( size_, 0 );
+		row_close_.assign( size_, 0 );
+		row_filled_.assign( size_, 0 );
+		row_.assign( size_, 0 );
+		row_empty_ = true;
+	}
+
+	std::size_t CorrelationMatrix::size() const {
+		return size_;
+	}
+
+	void CorrelationMatrix::addClose( std::size_t instrument, double close ) {
+		if ( instrument >= size_ || close <= 0 ) return;
+
+		if ( row_filled_[instrument] ) {
+			commitRow();
+		}
+		row_close_[instrument]  = close;
+		row_filled_[instrument] = 1;
+		row_empty_ = false;
+	}
+
+	void CorrelationMatrix::commitRow() {
+		if ( row_empty_ ) return;
+
+		for ( std::size_t i = 0; i < size_; ++i ) {
+			row_[i] = 0;
+			if ( ! row_filled_[i] ) continue;
+
+			if ( last_close_[i] > 0 ) {
+				row_[i] = row_close_[i] / last_close_[i] - 1;
+			}
+			last_close_[i] = row_close_[i];
+			row_filled_[i] = 0;
+		}
+		row_empty_ = true;
+
+		addReturns( row_.data() );
+	}
+
+	void CorrelationMatrix::addReturns( const double* returns ) {
+		// the ring starts zeroed, so subtracting the oldest row is a no-op
+		// until the window is full
+		double* oldest = &returns_[ head_ * size_ ];
+
+		for ( std::size_t i = 0; i < size_; ++i ) {
+			sum_[i] += returns[i] - oldest[i];
+		}
+
+		// rank two update of the upper triangle, blocked by columns
+		for ( std::size_t block = 0; block < size_; block += kBlockSize ) {
+			std::size_t block_end = std::min( block + kBlockSize, size_ );
+			for ( std::size_t i = 0; i < block_end; ++i ) {
+				const double new_i = returns[i];
+				const double old_i = oldest[i];
+				double* row = &cross_[ i * size_ ];
+				for ( std::size_t j = std::max( i, block ); j < block_end; ++j ) {
+					row[j] += new_i * returns[j] - old_i * oldest[j];
+				}
+			}
+		}
+
+		std::copy( returns, returns + size_, oldest );
+		if ( ++head_ == period_ ) {
+			head_ = 0;
+		}
+		if ( count_ < period_ ) {
+			++count_;
+		}
+	}
+
+	bool CorrelationMatrix::ready() const {
+		return count_ == period_;
+	}
+
+	double CorrelationMatrix::covariance( std::size_t i, std::size_t j ) const {
+		if ( count_ < 2 ) return 0;
+		if ( i > j ) std::swap( i, j );
+		return ( cross_[ i * size_ + j ] - sum_[i] * sum_[j] / count_ ) / ( count_ - 1 );
+	}
+
+	double CorrelationMatrix::correlation( std::size_t i, std::size_t j ) const {
+		if ( i == j ) return 1;
+		double variance = covariance( i, i ) * covariance( j, j );
+		if ( variance <= 0 ) return 0;
+		return std::max( -1.0, std::min( 1.0, covariance( i, j ) / std::sqrt( variance ) ) );
+	}
+
+	std::vector<double> CorrelationMatrix::stddevs() const {
+		std::vector<double> result( size_, 0 );
+		for ( std::size_t i = 0; i < size_; ++i ) {
+			double variance = covariance( i, i );
+			result[i] = variance > 0 ? std::sqrt( variance ) : 0;
+		}
+		return result;
+	}
+
+	double CorrelationMatrix::maxAdditionalRisk( const std::vector<double>& open_risk, std::size_t instrument, double direction, double cap ) const {
+		if ( cap <= 0 || instrument >= size_ ) return 0;
+
+		std::vector<double> stddev = stddevs();
+		auto rho = [&]( std::size_t i, std::size_t j ) -> double {
+			if ( i == j ) return 1;
+			if ( stddev[i] <= 0 || stddev[j] <= 0 ) return 0;
+			double value = covariance( i, j ) / ( stddev[i] * stddev[j] );
+			return std::max( -1.0, std::min( 1.0, value ) );
+		};
+
+		// only open positions contribute
+		std::vector<std::size_t> open;
+		for ( std::size_t i = 0; i < open_risk.size() && i < size_; ++i ) {
+			if ( open_risk[i] != 0 ) open.push_back( i );
+		}
+
+		// portfolio risk with a new position x: sqrt( risk + 2 * x * cross + x^2 )
+		double risk  = 0;
+		double cross = 0;
+		for ( std::size_t a = 0; a < open.size(); ++a ) {
+			std::size_t i = open[a];
+			for ( std::size_t b = 0; b < open.size(); ++b ) {
+				std::size_t j = open[b];
+				risk += open_risk[i] * open_risk[j] * rho( i, j );
+			}
+			cross += direction * open_risk[i] * rho( instrument, i );
+		}
+
+		// a book at or above the cap leaves no room, even a hedge that
+		// lowers the portfolio risk would be sized above the cap
+		if ( risk >= cap * cap ) return 0;
+
+		// x = 0 is feasible, so the roots enclose it and the upper one is
+		// the largest feasible size
+		double discriminant = cross * cross - risk + cap * cap;
+		return -cross + std::sqrt( discriminant );
+	}
+};
@@ -0,0 +1,73 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fxcalc {
+	/**
+	 * Rolling covariance and correlation of returns of all instruments.
+	 * Each step updates the running cross products in O(N^2) instead of
+	 * recomputing the whole window. Only the upper triangle is stored.
+	 */
+	class CorrelationMatrix {
+	public:
+		explicit CorrelationMatrix( std::size_t period = 100 );
+
+		// drops all data and tracks the given number of instruments
+		void resize( std::size_t instruments );
+		std::size_t size() const;
+
+		/**
+		 * Collects closes into a row of returns. A second close for an
+		 * instrument starts the next row, instruments without a close in
+		 * a row have a return of 0.
+		 */
+		void addClose( std::size_t instrument, double close );
+		// returns must point to size() values
+		void addReturns( const double* returns );
+
+		bool ready() const;
+		double covariance( std::size_t i, std::size_t j ) const;
+		double correlation( std::size_t i, std::size_t j ) const;
+
+		/**
+		 * Largest risk for a new position on instrument that keeps the
+		 * correlated risk of all positions within cap. open_risk holds
+		 * the signed risk per instrument, direction is 1 for long and -1
+		 * for short. 0 if the open positions already reach the cap.
+		 */
+		double maxAdditionalRisk( const std::vector<double>& open_risk, std::size_t instrument, double direction, double cap ) const;
+
+	private:
+		void commitRow();
+		std::vector<double> stddevs() const;
+
+		std::size_t size_;
+		std::size_t period_;
+		std::size_t head_;
+		std::size_t count_;
+		std::vector<double> returns_;  // period_ * size_ ring of rows
+		std::vector<double> sum_;
+		std::vector<double> cross_;    // size_ * size_, upper triangle used
+
+		std::vector<double> last_close_;
+		std::vector<double> row_close_;
+		std::vector<char> row_filled_;
+		std::vector<double> row_;
+		bool row_empty_;
+	};
+};
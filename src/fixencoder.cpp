@@ -0,0 +1,304 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "fixencoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace fxcalc {
+	namespace {
+		const char kSoh = '\x01';
+		const char kBeginString[] = "8=FIX.4.4\x01" "9=";
+
+		// writes value right aligned ending at end, returns the first digit
+		char* formatUnsigned( std::uint64_t value, char* end ) {
+			do {
+				*--end = static_cast<char>( '0' + value % 10 );
+				value /= 10;
+			} while ( value > 0 );
+			return end;
+		}
+
+		void putDigits( char* out, int value, int digits ) {
+			for ( int i = digits - 1; i >= 0; --i ) {
+				out[i] = static_cast<char>( '0' + value % 10 );
+				value /= 10;
+			}
+		}
+	}
+
+	FixEncoder::FixEncoder( const std::string& sender_comp_id, const std::string& target_comp_id ):
+		cursor_(buffer_), message_(buffer_), overflow_(false) {
+		prefix_.append( "49=" ).append( sender_comp_id ).append( 1, kSoh );
+		prefix_.append( "56=" ).append( target_comp_id ).append( 1, kSoh );
+	}
+
+	const char* FixEncoder::data() const {
+		return message_;
+	}
+
+	void FixEncoder::put( const char* text, std::size_t length ) {
+		// keep room for the checksum, never send a cut off field
+		std::size_t room = static_cast<std::size_t>( buffer_ + kBufferSize - 8 - cursor_ );
+		if ( overflow_ || length > room ) {
+			overflow_ = true;
+			return;
+		}
+		std::memcpy( cursor_, text, length );
+		cursor_ += length;
+	}
+
+	void FixEncoder::putTag( const char* tag ) {
+		put( tag, std::strlen( tag ) );
+		put( "=", 1 );
+	}
+
+	void FixEncoder::putInt( std::int64_t value ) {
+		char digits[24];
+		char* end = digits + sizeof( digits );
+		std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>( value ) : static_cast<std::uint64_t>( value );
+		char* first = formatUnsigned( magnitude, end );
+		if ( value < 0 ) {
+			*--first = '-';
+		}
+		put( first, static_cast<std::size_t>( end - first ) );
+	}
+
+	// UTCTimestamp YYYYMMDD-HH:MM:SS.sss
+	void FixEncoder::putTime( std::int64_t time ) {
+		std::int64_t days = time / 86400000;
+		std::int64_t ms   = time % 86400000;
+		if ( ms < 0 ) {
+			ms += 86400000;
+			--days;
+		}
+
+		// civil date from days since epoch
+		days += 719468;
+		std::int64_t era = ( days >= 0 ? days : days - 146096 ) / 146097;
+		unsigned doe = static_cast<unsigned>( days - era * 146097 );
+		unsigned yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+		std::int64_t year = static_cast<std::int64_t>( yoe ) + era * 400;
+		unsigned doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+		unsigned mp  = ( 5 * doy + 2 ) / 153;
+		unsigned day = doy - ( 153 * mp + 2 ) / 5 + 1;
+		unsigned month = mp < 10 ? mp + 3 : mp - 9;
+		if ( month <= 2 ) {
+			++year;
+		}
+
+		char text[21];
+		putDigits( text, static_cast<int>( year ), 4 );
+		putDigits( text + 4, static_cast<int>( month ), 2 );
+		putDigits( text + 6, static_cast<int>( day ), 2 );
+		text[8] = '-';
+		putDigits( text + 9, static_cast<int>( ms / 3600000 ), 2 );
+		text[11] = ':';
+		putDigits( text + 12, static_cast<int>( ms / 60000 % 60 ), 2 );
+		text[14] = ':';
+		putDigits( text + 15, static_cast<int>( ms / 1000 % 60 ), 2 );
+		text[17] = '.';
+		putDigits( text + 18, static_cast<int>( ms % 1000 ), 3 );
+		put( text, sizeof( text ) );
+	}
+
+	void FixEncoder::begin( const char* msg_type, std::uint32_t seq_num, std::int64_t time ) {
+		// body starts after room for BeginString and BodyLength
+		cursor_   = buffer_ + kHeaderReserve;
+		overflow_ = false;
+		putTag( "35" );
+		put( msg_type, std::strlen( msg_type ) );
+		put( &kSoh, 1 );
+		put( prefix_.data(), prefix_.size() );
+		putTag( "34" );
+		putInt( seq_num );
+		put( &kSoh, 1 );
+		putTag( "52" );
+		putTime( time );
+		put( &kSoh, 1 );
+	}
+
+	std::size_t FixEncoder::finish() {
+		if ( overflow_ ) return 0;
+
+		char* body = buffer_ + kHeaderReserve;
+		std::size_t body_length = static_cast<std::size_t>( cursor_ - body );
+
+		// BeginString and BodyLength right before the body
+		char* length_end = body - 1;
+		*length_end = kSoh;
+		char* length_first = formatUnsigned( body_length, length_end );
+		message_ = length_first - ( sizeof( kBeginString ) - 1 );
+		std::memcpy( message_, kBeginString, sizeof( kBeginString ) - 1 );
+
+		unsigned checksum = 0;
+		for ( const char* it = message_; it < cursor_; ++it ) {
+			checksum += static_cast<unsigned char>( *it );
+		}
+		char trailer[7] = { '1', '0', '=', 0, 0, 0, kSoh };
+		putDigits( trailer + 3, static_cast<int>( checksum % 256 ), 3 );
+		std::memcpy( cursor_, trailer, sizeof( trailer ) );
+		cursor_ += sizeof( trailer );
+
+		return static_cast<std::size_t>( cursor_ - message_ );
+	}
+
+	std::size_t FixEncoder::logon( std::uint32_t seq_num, int heartbeat_interval, bool reset_seq_num, std::int64_t time ) {
+		begin( "A", seq_num, time );
+		putTag( "98" );
+		put( "0", 1 );
+		put( &kSoh, 1 );
+		putTag( "108" );
+		putInt( heartbeat_interval );
+		put( &kSoh, 1 );
+		if ( reset_seq_num ) {
+			putTag( "141" );
+			put( "Y", 1 );
+			put( &kSoh, 1 );
+		}
+		return finish();
+	}
+
+	std::size_t FixEncoder::logout( std::uint32_t seq_num, std::int64_t time ) {
+		begin( "5", seq_num, time );
+		return finish();
+	}
+
+	std::size_t FixEncoder::heartbeat( std::uint32_t seq_num, std::int64_t time ) {
+		begin( "0", seq_num, time );
+		return finish();
+	}
+
+	std::size_t FixEncoder::heartbeat( std::uint32_t seq_num, const char* test_req_id, std::size_t test_req_id_length, std::int64_t time ) {
+		begin( "0", seq_num, time );
+		putTag( "112" );
+		put( test_req_id, test_req_id_length );
+		put( &kSoh, 1 );
+		return finish();
+	}
+
+	std::size_t FixEncoder::newOrderSingle( std::uint32_t seq_num, std::uint64_t cl_ord_id, const char* symbol,
+		Side side, std::int64_t quantity, std::int64_t time ) {
+		char side_text = static_cast<char>( side );
+
+		begin( "D", seq_num, time );
+		putTag( "11" );
+		putInt( static_cast<std::int64_t>( cl_ord_id ) );
+		put( &kSoh, 1 );
+		putTag( "55" );
+		put( symbol, std::strlen( symbol ) );
+		put( &kSoh, 1 );
+		putTag( "54" );
+		put( &side_text, 1 );
+		put( &kSoh, 1 );
+		putTag( "60" );
+		putTime( time );
+		put( &kSoh, 1 );
+		putTag( "38" );
+		putInt( quantity );
+		put( &kSoh, 1 );
+		// market order
+		putTag( "40" );
+		put( "1", 1 );
+		put( &kSoh, 1 );
+		return finish();
+	}
+
+	std::size_t FixEncoder::executionReport( std::uint32_t seq_num, const char* cl_ord_id, std::size_t cl_ord_id_length,
+		const char* symbol, std::size_t symbol_length, char side, std::int64_t quantity, std::int64_t time ) {
+		begin( "8", seq_num, time );
+		putTag( "37" );
+		put( cl_ord_id, cl_ord_id_length );
+		put( &kSoh, 1 );
+		putTag( "11" );
+		put( cl_ord_id, cl_ord_id_length );
+		put( &kSoh, 1 );
+		putTag( "17" );
+		putInt( seq_num );
+		put( &kSoh, 1 );
+		// filled
+		putTag( "150" );
+		put( "F", 1 );
+		put( &kSoh, 1 );
+		putTag( "39" );
+		put( "2", 1 );
+		put( &kSoh, 1 );
+		putTag( "55" );
+		put( symbol, symbol_length );
+		put( &kSoh, 1 );
+		putTag( "54" );
+		put( &side, 1 );
+		put( &kSoh, 1 );
+		putTag( "38" );
+		putInt( quantity );
+		put( &kSoh, 1 );
+		putTag( "14" );
+		putInt( quantity );
+		put( &kSoh, 1 );
+		putTag( "151" );
+		put( "0", 1 );
+		put( &kSoh, 1 );
+		putTag( "6" );
+		put( "0", 1 );
+		put( &kSoh, 1 );
+		return finish();
+	}
+
+	std::size_t FixEncoder::messageLength( const char* data, std::size_t size ) {
+		// 8=FIX.4.4<SOH>9=len<SOH>
+		const char* end          = data + size;
+		const char* begin_end    = std::find( data, end, kSoh );
+		if ( begin_end == end || end - begin_end < 4 ) return 0;
+		if ( begin_end[1] != '9' || begin_end[2] != '=' ) return 0;
+
+		std::size_t body_length = 0;
+		const char* it = begin_end + 3;
+		for ( ; it < end && *it >= '0' && *it <= '9'; ++it ) {
+			body_length = body_length * 10 + static_cast<std::size_t>( *it - '0' );
+		}
+		if ( it == end || *it != kSoh ) return 0;
+
+		// checksum field is 10=nnn<SOH>
+		std::size_t length = static_cast<std::size_t>( it + 1 - data ) + body_length + 7;
+		return length <= size ? length : 0;
+	}
+
+	std::size_t FixEncoder::garbageLength( const char* data, std::size_t size ) {
+		const char kStart[] = "8=FIX";
+		const std::size_t start_length = sizeof( kStart ) - 1;
+		for ( std::size_t i = 0; i < size; ++i ) {
+			if ( std::memcmp( data + i, kStart, std::min( start_length, size - i ) ) == 0 ) return i;
+		}
+		return size;
+	}
+
+	bool FixEncoder::field( const char* message, std::size_t length, const char* tag,
+		const char** value, std::size_t* value_length ) {
+		std::size_t tag_length = std::strlen( tag );
+		const char* end = message + length;
+		const char* it  = message;
+		while ( it < end ) {
+			const char* field_end = std::find( it, end, kSoh );
+			if ( static_cast<std::size_t>( field_end - it ) > tag_length
+				&& std::memcmp( it, tag, tag_length ) == 0 && it[tag_length] == '=' ) {
+				*value        = it + tag_length + 1;
+				*value_length = static_cast<std::size_t>( field_end - *value );
+				return true;
+			}
+			it = field_end + 1;
+		}
+		return false;
+	}
+};
@@ -0,0 +1,79 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fxcalc {
+	/**
+	 * Encodes FIX 4.4 messages into a preallocated buffer. Header and
+	 * static fields are prepared once, encoding a message does not
+	 * allocate. The returned message stays valid until the next call.
+	 * A message that doesn't fit into the buffer is not encoded, the
+	 * length is 0 then.
+	 */
+	class FixEncoder {
+	public:
+		enum Side {
+			BUY  = '1',
+			SELL = '2'
+		};
+
+		FixEncoder( const std::string& sender_comp_id, const std::string& target_comp_id );
+
+		// time is in milliseconds since epoch, all return the message length
+		// reset_seq_num sets ResetSeqNumFlag, both sides start at 1 again
+		std::size_t logon( std::uint32_t seq_num, int heartbeat_interval, bool reset_seq_num, std::int64_t time );
+		std::size_t logout( std::uint32_t seq_num, std::int64_t time );
+		std::size_t heartbeat( std::uint32_t seq_num, std::int64_t time );
+		// answer to a TestRequest
+		std::size_t heartbeat( std::uint32_t seq_num, const char* test_req_id, std::size_t test_req_id_length, std::int64_t time );
+		std::size_t newOrderSingle( std::uint32_t seq_num, std::uint64_t cl_ord_id, const char* symbol,
+			Side side, std::int64_t quantity, std::int64_t time );
+		std::size_t executionReport( std::uint32_t seq_num, const char* cl_ord_id, std::size_t cl_ord_id_length,
+			const char* symbol, std::size_t symbol_length, char side, std::int64_t quantity, std::int64_t time );
+
+		const char* data() const;
+
+		// length of the first complete message in data, 0 if incomplete
+		static std::size_t messageLength( const char* data, std::size_t size );
+		// bytes in front of the first message start "8=FIX" in data, a
+		// start cut off at the end of data is not counted
+		static std::size_t garbageLength( const char* data, std::size_t size );
+		// value of tag in a message, false if the tag is missing
+		static bool field( const char* message, std::size_t length, const char* tag,
+			const char** value, std::size_t* value_length );
+
+	private:
+		static const std::size_t kHeaderReserve = 32;
+		static const std::size_t kBufferSize    = 1024;
+
+		void begin( const char* msg_type, std::uint32_t seq_num, std::int64_t time );
+		std::size_t finish();
+
+		void put( const char* text, std::size_t length );
+		void putTag( const char* tag );
+		void putInt( std::int64_t value );
+		void putTime( std::int64_t time );
+
+		std::string prefix_;   // 49=sender<SOH>56=target<SOH>
+		char buffer_[kBufferSize];
+		char* cursor_;
+		char* message_;
+		bool overflow_;
+	};
+};
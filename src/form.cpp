@@ -33,6 +33,18 @@ namespace fxcalc {
 		edit_commission_             = new QLineEdit;
 		edit_instrument_rate_        = new QLineEdit;
 		edit_margin_instrument_rate_ = new QLineEdit;
+		edit_atr_multiplier_         = new QLineEdit;
+		edit_bar_feed_               = new QLineEdit;
+		edit_portfolio_risk_         = new QLineEdit;
+		edit_open_positions_         = new QLineEdit;
+		edit_fix_acceptor_           = new QLineEdit;
+		edit_sender_comp_id_         = new QLineEdit;
+		edit_target_comp_id_         = new QLineEdit;
+		edit_trade_history_          = new QLineEdit;
+		chk_atr_stop_                = new QCheckBox(tr("Stop from ATR, x"));
+		chk_correlation_cap_         = new QCheckBox(tr("Cap correlated risk, %"));
+		cb_direction_                = new QComboBox;
+		cb_risk_mode_                = new QComboBox;
 		cb_account_currency_         = new QComboBox;
 		cb_instrument_               = new QComboBox;
 		label_result_risk_           = new QLabel;
@@ -43,6 +55,7 @@ namespace fxcalc {
 		label_commission_            = new QLabel;		
 		btn_units_clipboard_         = new QPushButton(tr("Copy"));
 		btn_lots_clipboard_          = new QPushButton(tr("Copy"));
+		btn_send_                    = new QPushButton(tr("Buy"));
 
 		// set alignment
 		edit_account_balance_->setAlignment(Qt::AlignRight);
@@ -54,6 +67,8 @@ namespace fxcalc {
 		edit_commission_->setAlignment(Qt::AlignRight);
 		edit_instrument_rate_->setAlignment(Qt::AlignRight);
 		edit_margin_instrument_rate_->setAlignment(Qt::AlignRight);
+		edit_atr_multiplier_->setAlignment(Qt::AlignRight);
+		edit_portfolio_risk_->setAlignment(Qt::AlignRight);
 
 		label_result_risk_->setAlignment(Qt::AlignRight);
 		label_pip_value_->setAlignment(Qt::AlignRight);
@@ -66,6 +81,13 @@ namespace fxcalc {
 		// set validators and field policies
 		cb_account_currency_->setInsertPolicy( QComboBox::NoInsert );
 		cb_instrument_->setInsertPolicy( QComboBox::NoInsert );
+		cb_direction_->setInsertPolicy( QComboBox::NoInsert );
+		cb_direction_->addItem( tr("Long") );
+		cb_direction_->addItem( tr("Short") );
+		cb_risk_mode_->setInsertPolicy( QComboBox::NoInsert );
+		cb_risk_mode_->addItem( tr("Fixed") );
+		cb_risk_mode_->addItem( tr("Kelly") );
+		cb_risk_mode_->addItem( tr("Optimal f") );
 
 		auto balance_validator    = new QDoubleValidator(0, 999999999, 2, edit_account_balance_ );
 		balance_validator->setNotation( QDoubleValidator::StandardNotation );
@@ -88,6 +110,26 @@ namespace fxcalc {
 		auto pip_validator        = new QIntValidator(0, 999999 );
 		edit_sl_pips_->setValidator( pip_validator );
 
+		auto atr_validator        = new QDoubleValidator(0, 100, 2, edit_atr_multiplier_ );
+		atr_validator->setNotation( QDoubleValidator::StandardNotation );
+		atr_validator->setLocale(QLocale::c());
+		edit_atr_multiplier_->setValidator( atr_validator );
+
+		edit_bar_feed_->setPlaceholderText(tr("bars.csv or host:port"));
+
+		auto portfolio_validator  = new QDoubleValidator(0, 100, 2, edit_portfolio_risk_ );
+		portfolio_validator->setNotation( QDoubleValidator::StandardNotation );
+		portfolio_validator->setLocale(QLocale::c());
+		edit_portfolio_risk_->setValidator( portfolio_validator );
+
+		// signed risk in account currency, negative for short positions
+		edit_open_positions_->setPlaceholderText(tr("EURUSD 50, GBPUSD -25"));
+
+		edit_fix_acceptor_->setPlaceholderText(tr("host:port"));
+
+		// one outcome in R per line
+		edit_trade_history_->setPlaceholderText(tr("outcomes.txt"));
+
 		// create form labels
 		QLabel* label_account_balance   = new QLabel(tr("Account Balance"));
 		QLabel* label_account_currency  = new QLabel(tr("Account Denomination"));
@@ -103,35 +145,54 @@ namespace fxcalc {
 		QLabel* label_pip_value         = new QLabel(tr("Pip Value"));
 		QLabel* label_commission        = new QLabel(tr("Commission per 1k Lot"));
 		QLabel* label_commissions       = new QLabel(tr("Commission open+close"));
+		QLabel* label_bar_feed          = new QLabel(tr("Bar Feed"));
+		QLabel* label_risk_mode         = new QLabel(tr("Risk Mode"));
+		QLabel* label_trade_history     = new QLabel(tr("Trade History"));
+		QLabel* label_open_positions    = new QLabel(tr("Open Risk"));
+		QLabel* label_direction         = new QLabel(tr("Direction"));
+		QLabel* label_fix_acceptor      = new QLabel(tr("FIX Acceptor"));
+		QLabel* label_sender_comp_id    = new QLabel(tr("SenderCompID"));
+		QLabel* label_target_comp_id    = new QLabel(tr("TargetCompID"));
 
 		// create groups
 		QGroupBox* group_inputs   = new QGroupBox;
 		QGroupBox* group_pos_size = new QGroupBox(tr("Position Size"));
 		QGroupBox* group_margin   = new QGroupBox(tr("Margin Requirements"));
+		QGroupBox* group_portfolio = new QGroupBox(tr("Portfolio"));
+		QGroupBox* group_order    = new QGroupBox(tr("Order Ticket"));
 
 		// create layouts
 		QGridLayout* layout_inputs   = new QGridLayout;
 		QGridLayout* layout_pos_size = new QGridLayout;
 		QGridLayout* layout_margin   = new QGridLayout;
+		QGridLayout* layout_portfolio = new QGridLayout;
+		QGridLayout* layout_order    = new QGridLayout;
 		layout_inputs->setColumnMinimumWidth(0, 150);
 		layout_pos_size->setColumnMinimumWidth(0, 150);
 		layout_margin->setColumnMinimumWidth(0, 150);
+		layout_portfolio->setColumnMinimumWidth(0, 150);
+		layout_order->setColumnMinimumWidth(0, 150);
 
 		// create clipboard layouts
 		QHBoxLayout* layout_copy_units    = new QHBoxLayout;
 		QHBoxLayout* layout_copy_lots     = new QHBoxLayout;
 		QHBoxLayout* layout_pips          = new QHBoxLayout;
+		QHBoxLayout* layout_atr_stop      = new QHBoxLayout;
 
 		// combine clipboard button with line edits
 		layout_copy_units->addWidget(btn_units_clipboard_);
 		layout_copy_units->addWidget(edit_units_);
 		layout_copy_lots->addWidget(btn_lots_clipboard_);
 		layout_copy_lots->addWidget(edit_lots_);
+		layout_atr_stop->addWidget(chk_atr_stop_);
+		layout_atr_stop->addWidget(edit_atr_multiplier_);
 
 		// set group layouts
 		group_inputs->setLayout( layout_inputs );
 		group_pos_size->setLayout( layout_pos_size );
 		group_margin->setLayout( layout_margin );
+		group_portfolio->setLayout( layout_portfolio );
+		group_order->setLayout( layout_order );
 
 		// add form rows and columns
 		// - inputs
@@ -143,12 +204,19 @@ namespace fxcalc {
 		layout_inputs->addWidget(edit_risk_percent_, 2, 1);
 		layout_inputs->addWidget(label_pips, 3, 0);
 		layout_inputs->addWidget(edit_sl_pips_, 3, 1);
-		layout_inputs->addWidget(label_commission, 4, 0);
-		layout_inputs->addWidget(edit_commission_, 4, 1);
-		layout_inputs->addWidget(label_instrument, 5, 0);
-		layout_inputs->addWidget(cb_instrument_, 5, 1);
-		layout_inputs->addWidget(label_instrument_rate_, 6, 0);
-		layout_inputs->addWidget(edit_instrument_rate_, 6, 1);
+		layout_inputs->addLayout(layout_atr_stop, 4, 1);
+		layout_inputs->addWidget(label_bar_feed, 5, 0);
+		layout_inputs->addWidget(edit_bar_feed_, 5, 1);
+		layout_inputs->addWidget(label_commission, 6, 0);
+		layout_inputs->addWidget(edit_commission_, 6, 1);
+		layout_inputs->addWidget(label_instrument, 7, 0);
+		layout_inputs->addWidget(cb_instrument_, 7, 1);
+		layout_inputs->addWidget(label_instrument_rate_, 8, 0);
+		layout_inputs->addWidget(edit_instrument_rate_, 8, 1);
+		layout_inputs->addWidget(label_risk_mode, 9, 0);
+		layout_inputs->addWidget(cb_risk_mode_, 9, 1);
+		layout_inputs->addWidget(label_trade_history, 10, 0);
+		layout_inputs->addWidget(edit_trade_history_, 10, 1);
 		// - pos_size
 		layout_pos_size->addWidget(label_pip_value, 0, 0);
 		layout_pos_size->addWidget(label_pip_value_, 0, 1);
@@ -167,12 +235,29 @@ namespace fxcalc {
 		layout_margin->addWidget(edit_margin_instrument_rate_, 1, 1);
 		layout_margin->addWidget(label_margin_required, 2, 0);
 		layout_margin->addWidget(label_margin_required_, 2, 1);
+		// - portfolio
+		layout_portfolio->addWidget(chk_correlation_cap_, 0, 0);
+		layout_portfolio->addWidget(edit_portfolio_risk_, 0, 1);
+		layout_portfolio->addWidget(label_open_positions, 1, 0);
+		layout_portfolio->addWidget(edit_open_positions_, 1, 1);
+		layout_portfolio->addWidget(label_direction, 2, 0);
+		layout_portfolio->addWidget(cb_direction_, 2, 1);
+		// - order ticket
+		layout_order->addWidget(label_fix_acceptor, 0, 0);
+		layout_order->addWidget(edit_fix_acceptor_, 0, 1);
+		layout_order->addWidget(label_sender_comp_id, 1, 0);
+		layout_order->addWidget(edit_sender_comp_id_, 1, 1);
+		layout_order->addWidget(label_target_comp_id, 2, 0);
+		layout_order->addWidget(edit_target_comp_id_, 2, 1);
+		layout_order->addWidget(btn_send_, 3, 1);
 
 		// create main layout
 		QVBoxLayout* layout_main = new QVBoxLayout;
 		layout_main->addWidget( group_inputs );
 		layout_main->addWidget( group_pos_size );
 		layout_main->addWidget( group_margin );
+		layout_main->addWidget( group_portfolio );
+		layout_main->addWidget( group_order );
 
 		setLayout( layout_main );
 	}
@@ -213,6 +298,54 @@ namespace fxcalc {
 		return edit_margin_instrument_rate_;
 	}
 
+	QLineEdit* Form::editAtrMultiplier() {
+		return edit_atr_multiplier_;
+	}
+
+	QLineEdit* Form::editBarFeed() {
+		return edit_bar_feed_;
+	}
+
+	QLineEdit* Form::editPortfolioRisk() {
+		return edit_portfolio_risk_;
+	}
+
+	QLineEdit* Form::editOpenPositions() {
+		return edit_open_positions_;
+	}
+
+	QLineEdit* Form::editFixAcceptor() {
+		return edit_fix_acceptor_;
+	}
+
+	QLineEdit* Form::editSenderCompId() {
+		return edit_sender_comp_id_;
+	}
+
+	QLineEdit* Form::editTargetCompId() {
+		return edit_target_comp_id_;
+	}
+
+	QLineEdit* Form::editTradeHistory() {
+		return edit_trade_history_;
+	}
+
+	QCheckBox* Form::chkAtrStop() {
+		return chk_atr_stop_;
+	}
+
+	QCheckBox* Form::chkCorrelationCap() {
+		return chk_correlation_cap_;
+	}
+
+	QComboBox* Form::cbDirection() {
+		return cb_direction_;
+	}
+
+	QComboBox* Form::cbRiskMode() {
+		return cb_risk_mode_;
+	}
+
 	QComboBox* Form::cbInstrument() {
 		return cb_instrument_;
 	}
@@ -253,4 +386,8 @@ namespace fxcalc {
 		return btn_lots_clipboard_;
 	}
 
+	QPushButton* Form::btnSend() {
+		return btn_send_;
+	}
+
 };
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <QComboBox>
 #include <QLabel>
 #include <QPushButton>
+#include <QCheckBox>
 
 namespace fxcalc {
 	class Form: public QWidget {
@@ -36,6 +37,18 @@ namespace fxcalc {
 		QLineEdit* editCommission();
 		QLineEdit* editInstrumentRate();
 		QLineEdit* editMarginInstrumentRate();
+		QLineEdit* editAtrMultiplier();
+		QLineEdit* editBarFeed();
+		QLineEdit* editPortfolioRisk();
+		QLineEdit* editOpenPositions();
+		QLineEdit* editFixAcceptor();
+		QLineEdit* editSenderCompId();
+		QLineEdit* editTargetCompId();
+		QLineEdit* editTradeHistory();
+		QCheckBox* chkAtrStop();
+		QCheckBox* chkCorrelationCap();
+		QComboBox* cbDirection();
+		QComboBox* cbRiskMode();
 		QComboBox* cbInstrument();
 		QComboBox* cbAccountCurrency();
 		QLabel* labelResultRisk();
@@ -46,6 +59,7 @@ namespace fxcalc {
 		QLabel* labelCommission();
 		QPushButton* btnCopyUnits();
 		QPushButton* btnCopyLots();
+		QPushButton* btnSend();
 
 	private:
 		QLineEdit* edit_account_balance_;
@@ -57,6 +71,18 @@ namespace fxcalc {
 		QLineEdit* edit_commission_;
 		QLineEdit* edit_instrument_rate_;
 		QLineEdit* edit_margin_instrument_rate_;
+		QLineEdit* edit_atr_multiplier_;
+		QLineEdit* edit_bar_feed_;
+		QLineEdit* edit_portfolio_risk_;
+		QLineEdit* edit_open_positions_;
+		QLineEdit* edit_fix_acceptor_;
+		QLineEdit* edit_sender_comp_id_;
+		QLineEdit* edit_target_comp_id_;
+		QLineEdit* edit_trade_history_;
+		QCheckBox* chk_atr_stop_;
+		QCheckBox* chk_correlation_cap_;
+		QComboBox* cb_direction_;
+		QComboBox* cb_risk_mode_;
 		QComboBox* cb_account_currency_;
 		QComboBox* cb_instrument_;
 		QLabel* label_result_risk_;
@@ -67,6 +93,7 @@ namespace fxcalc {
 		QLabel* label_commission_;
 		QPushButton* btn_units_clipboard_;
 		QPushButton* btn_lots_clipboard_;
+		QPushButton* btn_send_;
 
 	};
 };
\ No newline at end of file
@@ -0,0 +1,397 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "journal.h"
+#include "sizing.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fxcalc {
+	namespace {
+		// chunks smaller than this are not worth a thread
+		const std::size_t kMinChunkSize = 1 << 20;
+
+		typedef std::pair<const char*, const char*> Field;
+
+		struct Columns {
+			int instrument = -1;
+			int lots       = -1;
+			int units      = -1;
+			int open       = -1;
+			int close      = -1;
+			int sl         = -1;
+			int profit     = -1;
+			int balance    = -1;
+			int count      = 0;
+		};
+
+		struct Partial {
+			JournalStats total;
+			std::map<std::string, JournalStats> instruments;
+			std::size_t skipped = 0;
+		};
+
+		// trim blanks and quotes
+		Field trim( Field field ) {
+			while ( field.first < field.second && ( std::isspace( static_cast<unsigned char>( *field.first ) ) || *field.first == '"' ) ) {
+				++field.first;
+			}
+			while ( field.second > field.first && ( std::isspace( static_cast<unsigned char>( field.second[-1] ) ) || field.second[-1] == '"' ) ) {
+				--field.second;
+			}
+			return field;
+		}
+
+		// delimiters inside double quotes belong to the field
+		void split( const char* begin, const char* end, char delimiter, std::vector<Field>* fields ) {
+			fields->clear();
+			const char* start = begin;
+			bool quoted = false;
+			for ( const char* it = begin; it != end; ++it ) {
+				if ( *it == '"' ) {
+					quoted = ! quoted;
+				} else if ( *it == delimiter && ! quoted ) {
+					fields->push_back( trim( Field( start, it ) ) );
+					start = it + 1;
+				}
+			}
+			fields->push_back( trim( Field( start, end ) ) );
+		}
+
+		// a comma followed by exactly three digits
+		bool isGroupSeparator( const char* it, const char* end ) {
+			int count = 0;
+			for ( ++it; it < end && std::isdigit( static_cast<unsigned char>( *it ) ); ++it ) {
+				++count;
+			}
+			return count == 3;
+		}
+
+		/**
+		 * Parses a plain decimal number. strtod depends on the locale the
+		 * application runs in, statements always use a decimal point.
+		 * Commas between groups of three digits are thousands separators.
+		 */
+		bool parseNumber( Field field, double* value ) {
+			const char* it = field.first;
+			bool negative = false;
+			if ( it < field.second && ( *it == '-' || *it == '+' ) ) {
+				negative = *it == '-';
+				++it;
+			}
+
+			double result  = 0;
+			bool digits    = false;
+			for ( ; it < field.second; ++it ) {
+				if ( *it == ',' && digits && isGroupSeparator( it, field.second ) ) continue;
+				if ( ! std::isdigit( static_cast<unsigned char>( *it ) ) ) break;
+				result = result * 10 + ( *it - '0' );
+				digits = true;
+			}
+			if ( it < field.second && *it == '.' ) {
+				double scale = 0.1;
+				for ( ++it; it < field.second && std::isdigit( static_cast<unsigned char>( *it ) ); ++it ) {
+					result += ( *it - '0' ) * scale;
+					scale  *= 0.1;
+					digits  = true;
+				}
+			}
+			// exponent is a plain signed integer
+			if ( digits && it < field.second && ( *it == 'e' || *it == 'E' ) ) {
+				++it;
+				bool negative_power = false;
+				if ( it < field.second && ( *it == '-' || *it == '+' ) ) {
+					negative_power = *it == '-';
+					++it;
+				}
+				int power = 0;
+				bool power_digits = false;
+				for ( ; it < field.second && std::isdigit( static_cast<unsigned char>( *it ) ); ++it ) {
+					// beyond the range of double anyway
+					if ( power < 1000 ) power = power * 10 + ( *it - '0' );
+					power_digits = true;
+				}
+				if ( ! power_digits ) return false;
+				result *= std::pow( 10.0, negative_power ? -power : power );
+			}
+			if ( ! digits || it != field.second ) return false;
+
+			*value = negative ? -result : result;
+			return true;
+		}
+
+		bool number( const std::vector<Field>& fields, int column, double* value ) {
+			if ( column < 0 || column >= static_cast<int>( fields.size() ) ) return false;
+			return parseNumber( fields[column], value );
+		}
+
+		// "eur/usd" => EURUSD
+		std::string instrumentName( Field field ) {
+			std::string result;
+			for ( const char* it = field.first; it < field.second; ++it ) {
+				if ( std::isalpha( static_cast<unsigned char>( *it ) ) ) {
+					result.push_back( static_cast<char>( std::toupper( static_cast<unsigned char>( *it ) ) ) );
+				}
+			}
+			return result;
+		}
+
+		bool parseHeader( const char* begin, const char* end, char delimiter, Columns* columns ) {
+			std::vector<Field> fields;
+			split( begin, end, delimiter, &fields );
+			columns->count = static_cast<int>( fields.size() );
+
+			for ( int i = 0; i < columns->count; ++i ) {
+				std::string name( fields[i].first, fields[i].second );
+				std::transform( name.begin(), name.end(), name.begin(), []( char c ) {
+					return static_cast<char>( std::tolower( static_cast<unsigned char>( c ) ) );
+				});
+
+				if ( name == "instrument" || name == "symbol" ) columns->instrument = i;
+				else if ( name == "lots" || name == "volume" ) columns->lots = i;
+				else if ( name == "units" ) columns->units = i;
+				else if ( name == "open" ) columns->open = i;
+				else if ( name == "close" ) columns->close = i;
+				else if ( name == "sl" ) columns->sl = i;
+				else if ( name == "profit" ) columns->profit = i;
+				else if ( name == "balance" ) columns->balance = i;
+			}
+
+			return columns->instrument >= 0 && ( columns->lots >= 0 || columns->units >= 0 )
+				&& columns->open >= 0 && columns->close >= 0 && columns->sl >= 0 && columns->profit >= 0;
+		}
+
+		void parseChunk( const char* begin, const char* end, char delimiter, const Columns& columns,
+			const JournalSettings& settings, Partial* partial ) {
+			std::vector<Field> fields;
+			fields.reserve( columns.count );
+
+			std::string last_name;
+			JournalStats* last_stats = nullptr;
+
+			while ( begin < end ) {
+				const char* line_end = std::find( begin, end, '\n' );
+				const char* line     = begin;
+				begin = line_end == end ? end : line_end + 1;
+
+				if ( line_end > line && line_end[-1] == '\r' ) --line_end;
+				if ( line_end == line ) continue;
+
+				split( line, line_end, delimiter, &fields );
+				if ( static_cast<int>( fields.size() ) <= columns.instrument ) {
+					++partial->skipped;
+					continue;
+				}
+
+				double units = 0, open = 0, close = 0, sl = 0, profit = 0;
+				bool ok = columns.units >= 0 ? number( fields, columns.units, &units ) : number( fields, columns.lots, &units );
+				if ( columns.units < 0 ) units *= kContractSize;
+				ok = ok && number( fields, columns.open, &open ) && number( fields, columns.close, &close )
+					&& number( fields, columns.sl, &sl ) && number( fields, columns.profit, &profit );
+
+				double balance = settings.balance;
+				if ( columns.balance >= 0 && ! number( fields, columns.balance, &balance ) ) {
+					balance = settings.balance;
+				}
+
+				std::string name = instrumentName( fields[columns.instrument] );
+				double risk = riskAmount( balance, settings.risk_percent );
+				if ( ! ok || name.size() != 6 || sl <= 0 || open == sl || units == 0 || risk <= 0 ) {
+					++partial->skipped;
+					continue;
+				}
+
+				// same pip and commission rules as calculate()
+				double pip_size   = pipSize( name.compare( 3, 3, "JPY" ) == 0 );
+				double sl_pips    = std::fabs( open - sl ) / pip_size;
+				double abs_units  = std::fabs( units );
+				double commission = commissionForLots( lotsForUnits( abs_units ), settings.commission );
+
+				if ( last_stats == nullptr || name != last_name ) {
+					last_name  = name;
+					last_stats = &partial->instruments[name];
+				}
+
+				JournalStats trade;
+				trade.trades       = 1;
+				trade.wins         = profit - commission > 0 ? 1 : 0;
+				trade.r_sum        = ( profit - commission ) / risk;
+				trade.profit       = profit;
+				trade.commission   = commission;
+				trade.commission_r = commission / risk;
+
+				// pip value per unit as realized by the trade itself
+				double move_pips = std::fabs( close - open ) / pip_size;
+				if ( move_pips > 0 ) {
+					double unit_costs    = std::fabs( profit ) / ( move_pips * abs_units );
+					trade.sized_trades   = 1;
+					trade.deviation_sum  = abs_units * sl_pips * unit_costs / risk - 1;
+				}
+
+				last_stats->merge( trade );
+				partial->total.merge( trade );
+			}
+		}
+	}
+
+	JournalStats::JournalStats():
+		trades(0), wins(0), sized_trades(0), r_sum(0), profit(0), commission(0), commission_r(0), deviation_sum(0) {}
+
+	void JournalStats::merge( const JournalStats& other ) {
+		trades        += other.trades;
+		wins          += other.wins;
+		sized_trades  += other.sized_trades;
+		r_sum         += other.r_sum;
+		profit        += other.profit;
+		commission    += other.commission;
+		commission_r  += other.commission_r;
+		deviation_sum += other.deviation_sum;
+	}
+
+	double JournalStats::expectancy() const {
+		return trades > 0 ? r_sum / trades : 0;
+	}
+
+	double JournalStats::winRate() const {
+		return trades > 0 ? static_cast<double>( wins ) / trades : 0;
+	}
+
+	double JournalStats::sizingDeviation() const {
+		return sized_trades > 0 ? deviation_sum / sized_trades : 0;
+	}
+
+	double JournalStats::commissionDrag() const {
+		return trades > 0 ? commission_r / trades : 0;
+	}
+
+	JournalImporter::JournalImporter( const JournalSettings& settings ): settings_(settings) {}
+
+	bool JournalImporter::importFile( const std::string& path, JournalReport* report, unsigned threads ) const {
+		std::ifstream file( path.c_str(), std::ios::in | std::ios::binary );
+		std::string data;
+		if ( file ) {
+			// read straight into a string of the file size
+			file.seekg( 0, std::ios::end );
+			std::streamoff size = file.tellg();
+			file.seekg( 0, std::ios::beg );
+			if ( size > 0 ) {
+				data.resize( static_cast<std::size_t>( size ) );
+				file.read( &data[0], size );
+			}
+		}
+		if ( ! file ) {
+			*report = JournalReport();
+			report->skipped = 0;
+			report->error   = "Couldn't read " + path;
+			return false;
+		}
+
+		return importData( data, report, threads );
+	}
+
+	bool JournalImporter::importData( const std::string& data, JournalReport* report, unsigned threads ) const {
+		*report = JournalReport();
+		report->skipped = 0;
+
+		const char* begin      = data.data();
+		const char* end        = begin + data.size();
+		const char* header_end = std::find( begin, end, '\n' );
+
+		// semicolon separated if the header has no comma
+		char delimiter = std::find( begin, header_end, ',' ) == header_end
+			&& std::find( begin, header_end, ';' ) != header_end ? ';' : ',';
+
+		Columns columns;
+		const char* header_last = header_end > begin && header_end[-1] == '\r' ? header_end - 1 : header_end;
+		if ( ! parseHeader( begin, header_last, delimiter, &columns ) ) {
+			report->error = "Statement needs the columns instrument, lots or units, open, close, sl and profit.";
+			return false;
+		}
+		begin = header_end == end ? end : header_end + 1;
+
+		if ( threads == 0 ) {
+			threads = std::max( 1u, std::thread::hardware_concurrency() );
+		}
+		std::size_t size = static_cast<std::size_t>( end - begin );
+		threads = static_cast<unsigned>( std::max<std::size_t>( 1, std::min<std::size_t>( threads, size / kMinChunkSize ) ) );
+
+		// cut chunks at line ends
+		std::vector<const char*> bounds;
+		bounds.push_back( begin );
+		for ( unsigned i = 1; i < threads; ++i ) {
+			const char* cut = std::max( bounds.back(), begin + size / threads * i );
+			cut = std::find( cut, end, '\n' );
+			bounds.push_back( cut == end ? end : cut + 1 );
+		}
+		bounds.push_back( end );
+
+		// an exception must not leave a thread, it is passed on per chunk
+		std::vector<Partial> partials( threads );
+		std::vector<std::exception_ptr> errors( threads );
+		auto parse = [&]( unsigned i ) {
+			try {
+				parseChunk( bounds[i], bounds[i + 1], delimiter, columns, settings_, &partials[i] );
+			} catch ( ... ) {
+				errors[i] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		unsigned started = 1;
+		try {
+			workers.reserve( threads - 1 );
+			for ( ; started < threads; ++started ) {
+				workers.push_back( std::thread( parse, started ) );
+			}
+		} catch ( ... ) {
+			// no more threads available, the calling thread parses the rest
+		}
+		for ( unsigned i = started; i < threads; ++i ) {
+			parse( i );
+		}
+		parse( 0 );
+		for ( std::thread& worker : workers ) {
+			worker.join();
+		}
+
+		for ( const std::exception_ptr& error : errors ) {
+			if ( ! error ) continue;
+			try {
+				std::rethrow_exception( error );
+			} catch ( const std::exception& e ) {
+				report->error = std::string( "Statement import failed: " ) + e.what();
+			} catch ( ... ) {
+				report->error = "Statement import failed.";
+			}
+			return false;
+		}
+
+		// merge per thread aggregates
+		for ( const Partial& partial : partials ) {
+			report->total.merge( partial.total );
+			report->skipped += partial.skipped;
+			for ( const auto& instrument : partial.instruments ) {
+				report->instruments[instrument.first].merge( instrument.second );
+			}
+		}
+		return true;
+	}
+};
@@ -0,0 +1,76 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace fxcalc {
+	// sizing rule the trades are measured against
+	struct JournalSettings {
+		double balance;       // used if the statement has no balance column
+		double risk_percent;
+		double commission;    // per 1k lot
+	};
+
+	struct JournalStats {
+		std::size_t trades;
+		std::size_t wins;
+		std::size_t sized_trades;  // trades with a known pip value
+		double r_sum;              // net profit in multiples of the prescribed risk
+		double profit;             // gross profit
+		double commission;
+		double commission_r;       // commission in multiples of the prescribed risk
+		double deviation_sum;      // actual risk / prescribed risk - 1
+
+		JournalStats();
+		void merge( const JournalStats& other );
+
+		double expectancy() const;
+		double winRate() const;
+		double sizingDeviation() const;
+		double commissionDrag() const;
+	};
+
+	struct JournalReport {
+		JournalStats total;
+		std::map<std::string, JournalStats> instruments;
+		std::size_t skipped;
+		std::string error;
+	};
+
+	/**
+	 * Imports closed trades from a broker statement csv and compares
+	 * them with the position size calculate() would have prescribed.
+	 *
+	 * The header names the columns, case insensitive: instrument, lots or
+	 * units, open, close, sl, profit and optionally balance. Fields are
+	 * separated by comma or semicolon, units are negative for short trades.
+	 * The data is split into chunks at line ends, every thread aggregates
+	 * its own chunk and the partial results are merged at the end.
+	 */
+	class JournalImporter {
+	public:
+		explicit JournalImporter( const JournalSettings& settings );
+
+		// threads 0 uses all cores
+		bool importFile( const std::string& path, JournalReport* report, unsigned threads = 0 ) const;
+		bool importData( const std::string& data, JournalReport* report, unsigned threads = 0 ) const;
+
+	private:
+		JournalSettings settings_;
+	};
+};
@@ -0,0 +1,178 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "libfxcalc.h"
+#include "sizing.h"
+#include "allocator.h"
+#include "stress.h"
+
+using namespace fxcalc;
+
+extern "C" {
+
+int fxcalc_abi_version( void ) {
+	return FXCALC_ABI_VERSION;
+}
+
+int fxcalc_unit_costs( size_t count,
+	const int32_t* conversion, const uint8_t* jpy_conversion, const double* rate,
+	double* out_unit_costs ) {
+	if ( count == 0 ) return FXCALC_OK;
+	if ( conversion == nullptr || jpy_conversion == nullptr || rate == nullptr || out_unit_costs == nullptr ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+
+	for ( size_t i = 0; i < count; ++i ) {
+		if ( conversion[i] < FXCALC_CONVERSION_NONE || conversion[i] > FXCALC_CONVERSION_BID ) return FXCALC_ERROR_ARGUMENT;
+	}
+
+	for ( size_t i = 0; i < count; ++i ) {
+		out_unit_costs[i] = unitCosts( static_cast<Conversion>( conversion[i] ), jpy_conversion[i] != 0, rate[i] );
+	}
+	return FXCALC_OK;
+}
+
+int fxcalc_position_size( size_t count,
+	const double* balance, const double* risk_percent, const double* sl_pips, const double* unit_costs,
+	double* out_units, double* out_lots, double* out_risk ) {
+	if ( count == 0 ) return FXCALC_OK;
+	if ( balance == nullptr || risk_percent == nullptr || sl_pips == nullptr || unit_costs == nullptr ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+
+	// one loop per requested column keeps each loop free of branches
+	if ( out_risk != nullptr ) {
+		for ( size_t i = 0; i < count; ++i ) {
+			out_risk[i] = riskAmount( balance[i], risk_percent[i] );
+		}
+	}
+	if ( out_units != nullptr ) {
+		for ( size_t i = 0; i < count; ++i ) {
+			out_units[i] = unitsForRisk( riskAmount( balance[i], risk_percent[i] ), sl_pips[i], unit_costs[i] );
+		}
+	}
+	if ( out_lots != nullptr ) {
+		for ( size_t i = 0; i < count; ++i ) {
+			out_lots[i] = lotsForUnits( unitsForRisk( riskAmount( balance[i], risk_percent[i] ), sl_pips[i], unit_costs[i] ) );
+		}
+	}
+	return FXCALC_OK;
+}
+
+int fxcalc_margin( size_t count,
+	const double* units, const double* margin_price, const double* margin_ratio,
+	double* out_margin ) {
+	if ( count == 0 ) return FXCALC_OK;
+	if ( units == nullptr || margin_price == nullptr || margin_ratio == nullptr || out_margin == nullptr ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+
+	for ( size_t i = 0; i < count; ++i ) {
+		out_margin[i] = marginForUnits( units[i], margin_price[i], margin_ratio[i] );
+	}
+	return FXCALC_OK;
+}
+
+int fxcalc_commission( size_t count,
+	const double* lots, const double* commission,
+	double* out_commission ) {
+	if ( count == 0 ) return FXCALC_OK;
+	if ( lots == nullptr || commission == nullptr || out_commission == nullptr ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+
+	for ( size_t i = 0; i < count; ++i ) {
+		out_commission[i] = commissionForLots( lots[i], commission[i] );
+	}
+	return FXCALC_OK;
+}
+
+int fxcalc_allocate_lots( size_t count,
+	const double* target_risk, const double* sl_pips, const double* unit_costs, const double* margin_price,
+	const double* min_lot, const double* lot_step, const double* max_lot,
+	double free_margin, double margin_ratio,
+	double* out_lots, double* out_margin, double* out_total_risk, double* out_risk_bound ) {
+	if ( count > 0 && ( target_risk == nullptr || sl_pips == nullptr || unit_costs == nullptr || margin_price == nullptr
+		|| min_lot == nullptr || lot_step == nullptr || max_lot == nullptr || out_lots == nullptr ) ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+	for ( size_t i = 0; i < count; ++i ) {
+		if ( lot_step[i] <= 0 || ( margin_ratio > 0 && margin_price[i] <= 0 ) ) return FXCALC_ERROR_ARGUMENT;
+	}
+
+	// no exception may cross the C interface
+	try {
+		std::vector<OrderRequest> orders( count );
+		for ( size_t i = 0; i < count; ++i ) {
+			OrderRequest& order = orders[i];
+			order.target_risk  = target_risk[i];
+			order.sl_pips      = sl_pips[i];
+			order.unit_costs   = unit_costs[i];
+			order.margin_price = margin_price[i];
+			order.min_lot      = min_lot[i];
+			order.lot_step     = lot_step[i];
+			order.max_lot      = max_lot[i];
+		}
+
+		AllocationResult result = LotAllocator( free_margin, margin_ratio ).allocate( orders );
+		for ( size_t i = 0; i < count; ++i ) {
+			out_lots[i] = result.allocations[i].lots;
+		}
+		if ( out_margin != nullptr ) {
+			for ( size_t i = 0; i < count; ++i ) {
+				out_margin[i] = result.allocations[i].margin;
+			}
+		}
+		if ( out_total_risk != nullptr ) *out_total_risk = result.total_risk;
+		if ( out_risk_bound != nullptr ) *out_risk_bound = result.risk_bound;
+	} catch ( ... ) {
+		return FXCALC_ERROR_INTERNAL;
+	}
+	return FXCALC_OK;
+}
+
+int fxcalc_stress( size_t position_count,
+	const uint32_t* base, const uint32_t* quote, const double* units, const double* price,
+	const double* quote_rate, const double* margin_price, const double* margin_ratio,
+	size_t currency_count, size_t scenario_count, const double* shocks,
+	double balance, double margin_call_level, double stop_out_level,
+	double* out_equity, double* out_margin, double* out_margin_level, uint8_t* out_flags,
+	unsigned thread_count ) {
+	if ( position_count > 0 && ( base == nullptr || quote == nullptr || units == nullptr || price == nullptr
+		|| quote_rate == nullptr || margin_price == nullptr || margin_ratio == nullptr ) ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+	for ( size_t i = 0; i < position_count; ++i ) {
+		if ( base[i] >= currency_count || quote[i] >= currency_count ) return FXCALC_ERROR_ARGUMENT;
+	}
+	if ( scenario_count == 0 ) return FXCALC_OK;
+	if ( shocks == nullptr || out_equity == nullptr || out_flags == nullptr ) {
+		return FXCALC_ERROR_ARGUMENT;
+	}
+
+	// no exception may cross the C interface
+	try {
+		StressTest stress( currency_count );
+		for ( size_t i = 0; i < position_count; ++i ) {
+			stress.addPosition( base[i], quote[i], units[i], price[i], quote_rate[i], margin_price[i], margin_ratio[i] );
+		}
+		stress.run( shocks, scenario_count, balance, margin_call_level, stop_out_level,
+			out_equity, out_margin, out_margin_level, out_flags, thread_count );
+	} catch ( ... ) {
+		return FXCALC_ERROR_INTERNAL;
+	}
+	return FXCALC_OK;
+}
+
+}
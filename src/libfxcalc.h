@@ -0,0 +1,144 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+/*
+ * libfxcalc: C interface to the position sizing formulas of FXCalc.
+ *
+ * All batch functions work on caller owned column arrays of length count
+ * and write into caller owned output arrays. The per row formulas copy
+ * and allocate nothing, fxcalc_allocate_lots and fxcalc_stress allocate
+ * working memory. Output pointers may be NULL if the column is not
+ * needed. Functions return FXCALC_OK, FXCALC_ERROR_ARGUMENT if a
+ * required pointer is NULL or an argument is out of range, or
+ * FXCALC_ERROR_INTERNAL if working memory or threads couldn't be
+ * allocated.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+	#if defined(FXCALC_BUILD_LIBRARY)
+		#define FXCALC_API __declspec(dllexport)
+	#else
+		#define FXCALC_API __declspec(dllimport)
+	#endif
+#else
+	#define FXCALC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FXCALC_ABI_VERSION 1
+
+#define FXCALC_OK              0
+#define FXCALC_ERROR_ARGUMENT -1
+#define FXCALC_ERROR_INTERNAL -2
+
+/* conversion of the quote currency into the account currency */
+#define FXCALC_CONVERSION_NONE 0 /* quote currency is the account currency */
+#define FXCALC_CONVERSION_ASK  1 /* account currency is base of the conversion pair */
+#define FXCALC_CONVERSION_BID  2 /* account currency is quote of the conversion pair */
+
+/* units per standard lot */
+#define FXCALC_CONTRACT_SIZE 100000.0
+
+FXCALC_API int fxcalc_abi_version( void );
+
+/*
+ * Pip value of one unit in account currency.
+ * jpy_conversion is non zero if the conversion pair is quoted in JPY,
+ * rate is the current price of the conversion pair. conversion must be
+ * one of FXCALC_CONVERSION_*.
+ */
+FXCALC_API int fxcalc_unit_costs( size_t count,
+	const int32_t* conversion, const uint8_t* jpy_conversion, const double* rate,
+	double* out_unit_costs );
+
+/*
+ * Position size for risking risk_percent of balance with a stop of sl_pips.
+ * out_risk receives the money at risk in account currency.
+ */
+FXCALC_API int fxcalc_position_size( size_t count,
+	const double* balance, const double* risk_percent, const double* sl_pips, const double* unit_costs,
+	double* out_units, double* out_lots, double* out_risk );
+
+/*
+ * Margin required to hold units. margin_price is the current ask of
+ * base/account currency, margin_ratio is n of n:1.
+ */
+FXCALC_API int fxcalc_margin( size_t count,
+	const double* units, const double* margin_price, const double* margin_ratio,
+	double* out_margin );
+
+/*
+ * Commission for entry and exit, commission is charged per 1k lot.
+ */
+FXCALC_API int fxcalc_commission( size_t count,
+	const double* lots, const double* commission,
+	double* out_commission );
+
+/*
+ * Rounds a basket of orders to broker lot sizes without exceeding
+ * free_margin. Each order risks at most target_risk in account currency;
+ * unit_costs is the pip value of one unit in account currency,
+ * margin_price the current ask of base/account currency. lot_step must be
+ * positive, as must margin_price unless margin_ratio is 0, which ignores
+ * margin. max_lot 0 means no limit. If the margin doesn't suffice
+ * orders with the most risk per margin are filled first.
+ * out_lots receives the lots per order, out_margin the margin per order.
+ * out_total_risk and out_risk_bound receive the allocated risk and the
+ * risk of the fractional lot optimum, an upper bound of it.
+ * The orders are copied into working memory.
+ */
+FXCALC_API int fxcalc_allocate_lots( size_t count,
+	const double* target_risk, const double* sl_pips, const double* unit_costs, const double* margin_price,
+	const double* min_lot, const double* lot_step, const double* max_lot,
+	double free_margin, double margin_ratio,
+	double* out_lots, double* out_margin, double* out_total_risk, double* out_risk_bound );
+
+/* flags of fxcalc_stress */
+#define FXCALC_STRESS_MARGIN_CALL 1
+#define FXCALC_STRESS_STOP_OUT    2
+
+/*
+ * Applies price shock scenarios to a portfolio of positions.
+ * Positions are given as columns of position_count values: base and quote
+ * are currency indices below currency_count, FXCALC_ERROR_ARGUMENT is
+ * returned for any other index. units are negative for short
+ * positions, quote_rate converts the quote currency into the account
+ * currency and margin_price is the current ask of base/account currency.
+ * shocks holds scenario_count rows of currency_count relative moves
+ * against the account currency. Levels are in percent, out_margin and
+ * out_margin_level may be NULL. thread_count limits the threads a large
+ * run is split over: 0 uses all cores, 1 runs on the calling thread only.
+ * Threads are started per call, callers running many small batches
+ * should pass 1. Unlike the batch functions above this one allocates
+ * working memory per currency.
+ */
+FXCALC_API int fxcalc_stress( size_t position_count,
+	const uint32_t* base, const uint32_t* quote, const double* units, const double* price,
+	const double* quote_rate, const double* margin_price, const double* margin_ratio,
+	size_t currency_count, size_t scenario_count, const double* shocks,
+	double balance, double margin_call_level, double stop_out_level,
+	double* out_equity, double* out_margin, double* out_margin_level, uint8_t* out_flags,
+	unsigned thread_count );
+
+#ifdef __cplusplus
+}
+#endif
@@ -13,6 +13,8 @@
 // along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
 
 #include "mainwindow.h"
+#include "sizing.h"
+#include "journal.h"
 
 #include <QDesktopWidget>
 #include <QClipboard>
@@ -28,11 +30,22 @@
 #include <QMessageBox>
 #include <QTextStream>
 #include <QMenuBar>
-
+#include <QTimer>
+#include <QDockWidget>
+#include <QTableView>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QThread>
+
+#include <algorithm>
 #include <cmath>
+#include <exception>
+#include <memory>
+#include <vector>
 
 namespace fxcalc {
-	MainWindow::MainWindow(): calc_mode_(CalcMode::NORMAL) {
+	MainWindow::MainWindow(): calc_mode_(CalcMode::NORMAL), kelly_risk_(0), optimal_f_risk_(0), stop_update_pending_(false), cap_update_pending_(false),
+		import_running_(false), order_units_(0), order_side_(FixEncoder::BUY), order_mode_(CalcMode::NORMAL) {
 		setWindowTitle( tr( "FX Calculator" ) );
 
 		auto screenRect = QApplication::desktop()->screenGeometry();
@@ -68,12 +81,31 @@ namespace fxcalc {
 				tr("FX Calculator\nVersion: %1.\nAuthor: Arne Gockeln\nUrl: https://arnegockeln.com").arg(PROJECT_VERSION)/* \n\nLicense:\n%2 .arg(copyright) */ );
 		});
 
+		QAction* action_import = new QAction(tr("&Import Statement..."), this);
+		connect(action_import, &QAction::triggered, this, &MainWindow::importStatement);
+
 		QMenu* file = menuBar()->addMenu(tr("&File"));
+		file->addAction(action_import);
 		file->addAction(action_about);
 
 		// setup form
 		initForm();
 
+		// watchlist of all instruments
+		QTableView* watchlist_view = new QTableView;
+		watchlist_view->setModel( watchlist_ );
+		watchlist_view->verticalHeader()->hide();
+		watchlist_view->horizontalHeader()->setSectionResizeMode( QHeaderView::Stretch );
+		watchlist_view->setSelectionBehavior( QAbstractItemView::SelectRows );
+
+		QDockWidget* watchlist_dock = new QDockWidget( tr("Watchlist"), this );
+		watchlist_dock->setWidget( watchlist_view );
+		addDockWidget( Qt::RightDockWidgetArea, watchlist_dock );
+		watchlist_dock->hide();
+
+		QMenu* view = menuBar()->addMenu(tr("&View"));
+		view->addAction( watchlist_dock->toggleViewAction() );
+
 		// macos specific settings
 		setUnifiedTitleAndToolBarOnMac(true);
 	}
@@ -125,12 +157,39 @@ namespace fxcalc {
 			QMessageBox::critical(this, tr("Error"), tr("Can't load instrument list!") );
 		}
 
+		QStringList instruments;
 		QTextStream in(&instrumentsFile);
 		while( ! in.atEnd() ) {
 			QString instrument = in.readLine();
 			form_->cbInstrument()->addItem( instrument );
+			instruments << instrument;
+			// track volatility for every instrument
+			instrument_index_[instrument] = volatility_.addInstrument( pipSize( instrument.mid(3, 3) == "JPY" ) );
 		}
 		instrumentsFile.close();
+		correlation_.resize( instrument_index_.size() );
+
+		watchlist_ = new WatchlistModel( currency_priority_, this );
+		watchlist_->setInstruments( instruments );
+
+		// FIX order ticket
+		order_session_ = new OrderSession(this);
+		connect( order_session_, &OrderSession::status, this, [this]( const QString& message ) {
+			statusBar()->showMessage( message, 3000 );
+		});
+		connect( order_session_, &OrderSession::orderFilled, this, [this]( std::uint64_t cl_ord_id, double latency_ms ) {
+			statusBar()->showMessage( tr("Order %1 filled after %2 ms.").arg( cl_ord_id ).arg( latency_ms, 0, 'f', 2 ), 3000 );
+		});
+		connect( order_session_, &OrderSession::orderRejected, this, [this]( std::uint64_t cl_ord_id, const QString& reason ) {
+			statusBar()->showMessage( tr("Order %1 rejected: %2").arg( cl_ord_id ).arg( reason ), 5000 );
+		});
+
+		// bar feed for volatility based stops
+		bar_feed_ = new BarFeed(this);
+		connect( bar_feed_, &BarFeed::barReceived, this, &MainWindow::onBarReceived );
+		connect( bar_feed_, &BarFeed::error, this, [this]( const QString& message ) {
+			statusBar()->showMessage( message, 3000 );
+		});
 
 		// load settings from file
 		load();
@@ -148,6 +207,39 @@ namespace fxcalc {
 		connect( form_->editMarginInstrumentRate(), &QLineEdit::editingFinished, this, &MainWindow::calculate);
 		connect( form_->cbInstrument(), &QComboBox::currentTextChanged, this, &MainWindow::calculate);
 		connect( form_->cbAccountCurrency(), &QComboBox::currentTextChanged, this, &MainWindow::calculate );
+		connect( form_->cbInstrument(), &QComboBox::currentTextChanged, this, &MainWindow::updateStopFromVolatility );
+		connect( form_->editAtrMultiplier(), &QLineEdit::editingFinished, this, &MainWindow::updateStopFromVolatility );
+		connect( form_->chkAtrStop(), &QCheckBox::toggled, this, [this]( bool checked ) {
+			form_->editSLPips()->setReadOnly( checked );
+			save();
+			updateStopFromVolatility();
+		});
+		connect( form_->chkCorrelationCap(), &QCheckBox::toggled, this, &MainWindow::calculate );
+		connect( form_->editPortfolioRisk(), &QLineEdit::editingFinished, this, &MainWindow::calculate );
+		connect( form_->editOpenPositions(), &QLineEdit::editingFinished, this, &MainWindow::calculate );
+		connect( form_->cbDirection(), &QComboBox::currentTextChanged, this, &MainWindow::calculate );
+		connect( form_->cbRiskMode(), static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this]( int index ) {
+			setRiskMode( index );
+			calculate();
+		});
+		connect( form_->editTradeHistory(), &QLineEdit::editingFinished, this, [this]() {
+			loadTradeHistory();
+			calculate();
+		});
+		connect( form_->editFixAcceptor(), &QLineEdit::editingFinished, this, &MainWindow::openOrderSession );
+		connect( form_->editSenderCompId(), &QLineEdit::editingFinished, this, &MainWindow::openOrderSession );
+		connect( form_->editTargetCompId(), &QLineEdit::editingFinished, this, &MainWindow::openOrderSession );
+		connect( form_->btnSend(), &QPushButton::clicked, this, &MainWindow::sendOrder );
+		// the order side follows the direction the units are calculated for
+		auto sendLabel = [this]( int index ) {
+			form_->btnSend()->setText( index == 1 ? tr("Sell") : tr("Buy") );
+		};
+		sendLabel( form_->cbDirection()->currentIndex() );
+		connect( form_->cbDirection(), static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, sendLabel );
+		connect( form_->editBarFeed(), &QLineEdit::editingFinished, this, [this]() {
+			bar_feed_->open( form_->editBarFeed()->text() );
+			save();
+		});
 		connect( form_->btnCopyUnits(), &QPushButton::clicked, [this]() {
 			// copy units to clipboard
 			auto clipboard = QGuiApplication::clipboard();
@@ -175,7 +267,20 @@ namespace fxcalc {
 	void MainWindow::calculate() {
 		// save values to json file
 		save();
+		recalculate();
+	}
 
+	// calculate without saving, for updates driven by the bar feed
+	void MainWindow::recalculate() {
+		calc_notice_.clear();
+
+		// units of an earlier calculation must never stay on screen or be
+		// sent if this one stops early
+		order_units_ = 0;
+		form_->editUnits()->clear();
+		form_->editLots()->clear();
+
+		bool history_risk = calc_mode_ == CalcMode::KELLY || calc_mode_ == CalcMode::OPTIMAL_F;
 		if ( form_->editRiskPercent()->text().isEmpty() ) return;
 		if ( form_->editAccountBalance()->text().isEmpty() ) return;
 		if ( form_->editSLPips()->text().isEmpty() ) return;
@@ -198,6 +303,9 @@ namespace fxcalc {
 			return;
 		}
 
+		// risk modes never risk more than the fixed risk percent
+		if ( history_risk && ! historyRiskPercent( &risk_percent ) ) return;
+
 		ok = false;
 		int sl_pips = QLocale::system().toInt( form_->editSLPips()->text(), &ok );
 		if ( ! ok ) {
@@ -224,13 +332,15 @@ namespace fxcalc {
 			}
 		}
 		
+		// watchlist follows the inputs, rates come from the bar feed
+		watchlist_->setInputs( account_size, risk_percent, sl_pips, margin_ratio, form_->cbAccountCurrency()->currentText() );
+
 		//
 		// ----------------------- DEFAULT VALUES
 		// 
-		double contract_size     = 100000;
+		double contract_size     = kContractSize;
 		double current_price     = 1;
 		double point_size        = 0.0001;
-		double unit_costs        = 0.0001;
 		QString account_currency = form_->cbAccountCurrency()->currentText();
 		int account_precision    = 5;
 		if ( account_currency == "JPY" ) {
@@ -243,7 +353,10 @@ namespace fxcalc {
 		QString quote_currency;
 		
 		// calculate risk in account currency
-		double risk = ( risk_percent * account_size ) / 100;
+		double risk = riskAmount( account_size, risk_percent );
+		if ( form_->chkCorrelationCap()->isChecked() ) {
+			risk = correlationCappedRisk( risk, account_size );
+		}
 
 		// get base and quote currency from pair by using regular expression
 		// split currency pair in two parts like: EURUSD => (EUR), (USD)
@@ -256,7 +369,7 @@ namespace fxcalc {
 
 		if ( quote_currency == "JPY" ) {
 			instrument_precision = 3;
-			point_size           = 0.01;
+			point_size           = pipSize( true );
 		}
 
 		// find rate for the second currency
@@ -293,23 +406,13 @@ namespace fxcalc {
 			}
 		}		
 		
+		Conversion conversion = Conversion::NONE;
 		if ( ! quote_aff_currency.isEmpty() ) {
-			if ( stype == "Ask" ) {
-				if ( quote_aff_currency == "JPY" ) {
-					unit_costs = unit_costs / ( current_price / 100 );
-				} else {
-					unit_costs = unit_costs / current_price;
-				}
-			} else {
-				if ( quote_aff_currency == "JPY" ) {
-					unit_costs = unit_costs * current_price / 100;
-				} else {
-					unit_costs = unit_costs * current_price;
-				}
-			}
+			conversion = ( stype == "Ask" ) ? Conversion::ASK : Conversion::BID;
 		}
+		double unit_costs = unitCosts( conversion, quote_aff_currency == "JPY", current_price );
 
-		double units = risk / sl_pips / unit_costs;
+		double units = unitsForRisk( risk, sl_pips, unit_costs );
 
 		// calculate margin requirements
 		// get price for margin calc
@@ -326,15 +429,13 @@ namespace fxcalc {
 			}
 		}
 
-		margin = ( margin_price * units ) / margin_ratio;
+		margin = marginForUnits( units, margin_price, margin_ratio );
 
 		// calculate lots
-		double lots = ( units / contract_size );
+		double lots = lotsForUnits( units );
 
 		// calculate commissions for entry and exit
-		if ( commissions > 0 ) {
-			commissions = ( ( lots * 100 ) * commissions ) * 2;
-		}
+		commissions = commissionForLots( lots, commissions );
 
 		//
 		// --------------- UPDATE UI
@@ -354,13 +455,296 @@ namespace fxcalc {
 		form_->editUnits()->setText( QString::number( units, 'f', 0 ) );
 		// set label lots
 		form_->editLots()->setText( QLocale::system().toString( lots, 'f', 3 ) );
+		// remember what the order ticket would send
+		order_units_      = std::llround( units );
+		order_instrument_ = form_->cbInstrument()->currentText();
+		order_side_       = form_->cbDirection()->currentIndex() == 1 ? FixEncoder::SELL : FixEncoder::BUY;
+		order_mode_       = calc_mode_;
 		// set edit for margin instrument rate
 		form_->editMarginInstrumentRate()->setText( QLocale::system().toString( margin_price, 'f', account_precision ) );
 		
 		// update statusbar
-		statusBar()->clearMessage();
-		// rest calc mode
-		calc_mode_ = CalcMode::NORMAL;
+		if ( calc_notice_.isEmpty() ) {
+			statusBar()->clearMessage();
+		} else {
+			statusBar()->showMessage( calc_notice_, 3000 );
+		}
+		// rest calc mode, risk modes stay until changed
+		if ( calc_mode_ == CalcMode::TP_RATE || calc_mode_ == CalcMode::TP_PIPS ) {
+			calc_mode_ = CalcMode::NORMAL;
+		}
+	}
+
+	// feed a bar into the volatility engine
+	void MainWindow::onBarReceived( const QString& instrument, double high, double low, double close ) {
+		// any pair may serve as conversion rate in the watchlist
+		watchlist_->setRate( instrument, close );
+
+		auto it = instrument_index_.find( instrument );
+		if ( it == instrument_index_.end() ) return;
+
+		volatility_.addBar( it->second, high, low, close );
+		correlation_.addClose( it->second, close );
+
+		// coalesce bursts of bars into a single update
+		if ( ! stop_update_pending_ && form_->chkAtrStop()->isChecked() && instrument == form_->cbInstrument()->currentText() ) {
+			stop_update_pending_ = true;
+			QTimer::singleShot( 0, this, &MainWindow::updateStopFromVolatility );
+		}
+
+		// the capped size follows the correlations, recalculate at most every 250 ms
+		if ( ! cap_update_pending_ && form_->chkCorrelationCap()->isChecked() ) {
+			cap_update_pending_ = true;
+			QTimer::singleShot( 250, this, [this]() {
+				cap_update_pending_ = false;
+				recalculate();
+			});
+		}
+	}
+
+	// set stop loss pips from the ATR of the current instrument
+	void MainWindow::updateStopFromVolatility() {
+		stop_update_pending_ = false;
+		if ( ! form_->chkAtrStop()->isChecked() ) return;
+
+		auto it = instrument_index_.find( form_->cbInstrument()->currentText() );
+		if ( it == instrument_index_.end() || ! volatility_.ready( it->second ) ) {
+			statusBar()->showMessage( tr("Waiting for bars to calculate ATR."), 3000 );
+			return;
+		}
+
+		double multiplier = 1;
+		if ( ! form_->editAtrMultiplier()->text().isEmpty() ) {
+			bool ok(false);
+			multiplier = QLocale::system().toDouble( form_->editAtrMultiplier()->text(), &ok );
+			if ( ! ok ) {
+				statusBar()->showMessage( tr("Couldn't convert ATR multiplier to double."), 3000 );
+				return;
+			}
+		}
+
+		int sl_pips = static_cast<int>( std::ceil( volatility_.atrPips( it->second ) * multiplier ) );
+		if ( sl_pips < 1 ) {
+			sl_pips = 1;
+		}
+
+		// only recalculate if the stop actually moved
+		QString text = QString::number( sl_pips );
+		if ( text == form_->editSLPips()->text() ) return;
+
+		form_->editSLPips()->setText( text );
+		recalculate();
+	}
+
+	// limit risk so the correlated risk of all open positions stays within the portfolio cap
+	double MainWindow::correlationCappedRisk( double risk, double account_size ) {
+		if ( ! correlation_.ready() ) {
+			calc_notice_ = tr("Waiting for bars to calculate correlations, risk is not capped.");
+			return risk;
+		}
+
+		auto it = instrument_index_.find( form_->cbInstrument()->currentText() );
+		if ( it == instrument_index_.end() ) return risk;
+
+		bool ok(false);
+		double portfolio_percent = QLocale::system().toDouble( form_->editPortfolioRisk()->text(), &ok );
+		if ( ! ok ) {
+			calc_notice_ = tr("Couldn't convert portfolio risk to double, risk is not capped.");
+			return risk;
+		}
+
+		// open positions: "EURUSD 50, GBPUSD -25"
+		std::vector<double> open_risk( correlation_.size(), 0 );
+		QStringList positions = form_->editOpenPositions()->text().split( ',', QString::SkipEmptyParts );
+		for ( const QString& position : positions ) {
+			QStringList fields = position.trimmed().split( QRegularExpression("\\s+") );
+			if ( fields.size() != 2 ) continue;
+
+			auto open = instrument_index_.find( fields[0].toUpper() );
+			if ( open == instrument_index_.end() ) continue;
+
+			double value = QLocale::c().toDouble( fields[1], &ok );
+			if ( ok ) {
+				open_risk[open->second] += value;
+			}
+		}
+
+		double direction = form_->cbDirection()->currentIndex() == 1 ? -1 : 1;
+		double cap       = riskAmount( account_size, portfolio_percent );
+
+		return std::min( risk, correlation_.maxAdditionalRisk( open_risk, it->second, direction, cap ) );
+	}
+
+	// compare trades of a broker statement with the current sizing rule
+	void MainWindow::importStatement() {
+		if ( import_running_ ) {
+			statusBar()->showMessage( tr("A statement is already being imported"), 3000 );
+			return;
+		}
+
+		QString fileName = QFileDialog::getOpenFileName( this, tr("Import Statement"), QString(), tr("Statements (*.csv *.txt)") );
+		if ( fileName.isEmpty() ) return;
+
+		JournalSettings settings;
+		settings.balance      = QLocale::system().toDouble( form_->editAccountBalance()->text() );
+		settings.risk_percent = QLocale::system().toDouble( form_->editRiskPercent()->text() );
+		settings.commission   = QLocale::system().toDouble( form_->editCommission()->text() );
+
+		// parse on a worker thread, the report is shown once it finished
+		std::string path = QFile::encodeName( fileName ).toStdString();
+		auto report      = std::make_shared<JournalReport>();
+		auto ok          = std::make_shared<bool>( false );
+		QThread* worker  = QThread::create( [settings, path, report, ok]() {
+			// e.g. a statement too large for memory, report it like any other error
+			try {
+				*ok = JournalImporter( settings ).importFile( path, report.get() );
+			} catch ( const std::exception& e ) {
+				*ok = false;
+				report->error = std::string( "Statement import failed: " ) + e.what();
+			}
+		});
+		connect( worker, &QThread::finished, this, [this, report, ok]() {
+			import_running_ = false;
+			statusBar()->clearMessage();
+			showStatementReport( *report, *ok );
+		});
+		connect( worker, &QThread::finished, worker, &QObject::deleteLater );
+
+		import_running_ = true;
+		statusBar()->showMessage( tr("Importing %1 ...").arg( fileName ) );
+		worker->start();
+	}
+
+	void MainWindow::showStatementReport( const JournalReport& report, bool ok ) {
+		if ( ! ok ) {
+			QMessageBox::critical( this, tr("Error"), QString::fromStdString( report.error ) );
+			return;
+		}
+
+		auto summary = [this]( const QString& name, const JournalStats& stats ) {
+			return tr("%1: %2 trades, expectancy %3 R, win rate %4 %, sizing deviation %5 %, commission drag %6 R")
+				.arg( name )
+				.arg( stats.trades )
+				.arg( QLocale::system().toString( stats.expectancy(), 'f', 2 ) )
+				.arg( QLocale::system().toString( stats.winRate() * 100, 'f', 1 ) )
+				.arg( QLocale::system().toString( stats.sizingDeviation() * 100, 'f', 1 ) )
+				.arg( QLocale::system().toString( stats.commissionDrag(), 'f', 3 ) );
+		};
+
+		QString details;
+		for ( const auto& instrument : report.instruments ) {
+			details.append( summary( QString::fromStdString( instrument.first ), instrument.second ) ).append( "\n" );
+		}
+
+		QMessageBox box( this );
+		box.setWindowTitle( tr("Statement") );
+		box.setText( summary( tr("Total"), report.total ) );
+		if ( report.skipped > 0 ) {
+			box.setInformativeText( tr("%1 lines skipped.").arg( report.skipped ) );
+		}
+		box.setDetailedText( details );
+		box.exec();
+	}
+
+	// load trade outcomes in R, one per line, and optimize the risk fraction once
+	void MainWindow::loadTradeHistory() {
+		kelly_risk_     = 0;
+		optimal_f_risk_ = 0;
+		if ( form_->editTradeHistory()->text().isEmpty() ) return;
+
+		QFile historyFile( form_->editTradeHistory()->text() );
+		if ( ! historyFile.open( QIODevice::ReadOnly ) ) {
+			statusBar()->showMessage( tr("Couldn't open %1").arg( historyFile.fileName() ), 3000 );
+			return;
+		}
+
+		std::vector<double> outcomes;
+		QByteArray data = historyFile.readAll();
+		historyFile.close();
+		for ( const QByteArray& line : data.split('\n') ) {
+			// first column, QByteArray::toDouble always uses a decimal point
+			bool ok(false);
+			double outcome = line.split(',').first().trimmed().toDouble( &ok );
+			if ( ok ) {
+				outcomes.push_back( outcome );
+			}
+		}
+
+		trade_history_.setOutcomes( outcomes );
+		kelly_risk_     = trade_history_.kellyRisk();
+		optimal_f_risk_ = trade_history_.optimalFRisk();
+	}
+
+	void MainWindow::setRiskMode( int index ) {
+		switch ( index ) {
+			case 1:  calc_mode_ = CalcMode::KELLY; break;
+			case 2:  calc_mode_ = CalcMode::OPTIMAL_F; break;
+			default: calc_mode_ = CalcMode::NORMAL; break;
+		}
+	}
+
+	// risk percent from the trade history in KELLY and OPTIMAL_F mode, the
+	// fixed risk percent passed in is the ceiling
+	bool MainWindow::historyRiskPercent( double* risk_percent ) {
+		if ( trade_history_.size() == 0 ) {
+			statusBar()->showMessage( tr("Load a trade history for this risk mode."), 3000 );
+			return false;
+		}
+		if ( ! trade_history_.hasLosses() ) {
+			statusBar()->showMessage( tr("Trade history has no losses, the risk can't be derived from it."), 3000 );
+			return false;
+		}
+
+		double ceiling = *risk_percent;
+		double history = ( calc_mode_ == CalcMode::KELLY ? kelly_risk_ : optimal_f_risk_ ) * 100;
+		*risk_percent  = std::min( history, ceiling );
+		calc_notice_   = tr("%1 risk %2 %").arg( form_->cbRiskMode()->currentText() )
+			.arg( QLocale::system().toString( history, 'f', 2 ) );
+		if ( history > ceiling ) {
+			calc_notice_ += tr(", capped at %1 %").arg( QLocale::system().toString( ceiling, 'f', 2 ) );
+		}
+		return true;
+	}
+
+	// (re)connect the order ticket to the FIX acceptor
+	void MainWindow::openOrderSession() {
+		save();
+		if ( form_->editFixAcceptor()->text().isEmpty() ) {
+			order_session_->close();
+			return;
+		}
+		order_session_->open( form_->editFixAcceptor()->text(), form_->editSenderCompId()->text(), form_->editTargetCompId()->text() );
+	}
+
+	// send the calculated units as market order, the side is the one
+	// the units were calculated for
+	void MainWindow::sendOrder() {
+		FixEncoder::Side side = form_->cbDirection()->currentIndex() == 1 ? FixEncoder::SELL : FixEncoder::BUY;
+		QString instrument    = form_->cbInstrument()->currentText();
+
+		// only units calculated for exactly this ticket
+		if ( order_units_ <= 0 || order_instrument_ != instrument || order_side_ != side || order_mode_ != calc_mode_ ) {
+			statusBar()->showMessage( tr("No units calculated for %1 to send.").arg( instrument ), 3000 );
+			return;
+		}
+
+		if ( ! order_session_->isOpen() ) {
+			statusBar()->showMessage( tr("Order session is not logged on."), 3000 );
+			return;
+		}
+
+		// bars may recalculate while the dialog is open, send what was confirmed
+		qlonglong units = order_units_;
+		QString question = tr("%1 %2 units of %3 at market?")
+			.arg( side == FixEncoder::SELL ? tr("Sell") : tr("Buy") ).arg( units ).arg( instrument );
+		if ( QMessageBox::question( this, tr("Send Order"), question, QMessageBox::Yes | QMessageBox::No, QMessageBox::No ) != QMessageBox::Yes ) {
+			return;
+		}
+
+		// the session reports why an order wasn't sent
+		std::uint64_t cl_ord_id = order_session_->sendOrder( instrument, side, units );
+		if ( cl_ord_id == 0 ) return;
+		statusBar()->showMessage( tr("Order %1 sent.").arg( cl_ord_id ), 3000 );
 	}
 
 	// save form data to file
@@ -386,6 +770,18 @@ namespace fxcalc {
 		json["currency"]     = form_->cbAccountCurrency()->currentText();
 		json["instrument"]   = form_->cbInstrument()->currentText();
 		json["currentask"]   = form_->editInstrumentRate()->text();
+		json["atrstop"]      = form_->chkAtrStop()->isChecked();
+		json["atrmultiplier"] = form_->editAtrMultiplier()->text();
+		json["barfeed"]      = form_->editBarFeed()->text();
+		json["correlationcap"] = form_->chkCorrelationCap()->isChecked();
+		json["portfoliorisk"] = form_->editPortfolioRisk()->text();
+		json["openpositions"] = form_->editOpenPositions()->text();
+		json["direction"]    = form_->cbDirection()->currentIndex();
+		json["fixacceptor"]  = form_->editFixAcceptor()->text();
+		json["riskmode"]     = form_->cbRiskMode()->currentIndex();
+		json["tradehistory"] = form_->editTradeHistory()->text();
+		json["sendercompid"] = form_->editSenderCompId()->text();
+		json["targetcompid"] = form_->editTargetCompId()->text();
 
 		QJsonDocument doc(json);
 
@@ -433,8 +829,51 @@ namespace fxcalc {
 		if ( json.contains("currentask") ) {
 			form_->editInstrumentRate()->setText( json["currentask"].toString() );
 		}
+		if ( json.contains("atrstop") ) {
+			form_->chkAtrStop()->setChecked( json["atrstop"].toBool() );
+			form_->editSLPips()->setReadOnly( form_->chkAtrStop()->isChecked() );
+		}
+		if ( json.contains("atrmultiplier") ) {
+			form_->editAtrMultiplier()->setText( json["atrmultiplier"].toString() );
+		}
+		if ( json.contains("correlationcap") ) {
+			form_->chkCorrelationCap()->setChecked( json["correlationcap"].toBool() );
+		}
+		if ( json.contains("portfoliorisk") ) {
+			form_->editPortfolioRisk()->setText( json["portfoliorisk"].toString() );
+		}
+		if ( json.contains("openpositions") ) {
+			form_->editOpenPositions()->setText( json["openpositions"].toString() );
+		}
+		if ( json.contains("direction") ) {
+			form_->cbDirection()->setCurrentIndex( json["direction"].toInt() );
+		}
+		if ( json.contains("tradehistory") ) {
+			form_->editTradeHistory()->setText( json["tradehistory"].toString() );
+			loadTradeHistory();
+		}
+		if ( json.contains("riskmode") ) {
+			form_->cbRiskMode()->setCurrentIndex( json["riskmode"].toInt() );
+			setRiskMode( form_->cbRiskMode()->currentIndex() );
+		}
+		if ( json.contains("sendercompid") ) {
+			form_->editSenderCompId()->setText( json["sendercompid"].toString() );
+		}
+		if ( json.contains("targetcompid") ) {
+			form_->editTargetCompId()->setText( json["targetcompid"].toString() );
+		}
+		if ( json.contains("fixacceptor") ) {
+			form_->editFixAcceptor()->setText( json["fixacceptor"].toString() );
+			if ( ! form_->editFixAcceptor()->text().isEmpty() ) {
+				order_session_->open( form_->editFixAcceptor()->text(), form_->editSenderCompId()->text(), form_->editTargetCompId()->text() );
+			}
+		}
+		if ( json.contains("barfeed") ) {
+			form_->editBarFeed()->setText( json["barfeed"].toString() );
+			bar_feed_->open( form_->editBarFeed()->text() );
+		}
 
-		calculate();
+		recalculate();
 	}
 
 };
\ No newline at end of file
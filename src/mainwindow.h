@@ -20,6 +20,13 @@
 #include <map>
 
 #include "form.h"
+#include "barfeed.h"
+#include "volatility.h"
+#include "correlation.h"
+#include "watchlist.h"
+#include "ordersession.h"
+#include "tradehistory.h"
+#include "journal.h"
 
 namespace fxcalc {
 class MainWindow: public QMainWindow {
@@ -29,7 +36,9 @@ public:
 	enum CalcMode {
 		NORMAL = 0,
 		TP_RATE,
-		TP_PIPS
+		TP_PIPS,
+		KELLY,
+		OPTIMAL_F
 	};
 
 	MainWindow();
@@ -39,11 +48,42 @@ public slots:
 
 private:
 	void initForm();
+	void recalculate();
 	void save();
 	void load();
+	void onBarReceived( const QString& instrument, double high, double low, double close );
+	void updateStopFromVolatility();
+	double correlationCappedRisk( double risk, double account_size );
+	void importStatement();
+	void showStatementReport( const JournalReport& report, bool ok );
+	void openOrderSession();
+	void sendOrder();
+	void loadTradeHistory();
+	void setRiskMode( int index );
+	bool historyRiskPercent( double* risk_percent );
 
 	CalcMode calc_mode_;
 	Form* form_;
+	BarFeed* bar_feed_;
+	WatchlistModel* watchlist_;
+	OrderSession* order_session_;
+	TradeHistory trade_history_;
+	double kelly_risk_;
+	double optimal_f_risk_;
+	VolatilityEngine volatility_;
+	CorrelationMatrix correlation_;
+	bool stop_update_pending_;
+	bool cap_update_pending_;
+	bool import_running_;
+	// units of the last complete calculation and what they were calculated
+	// for, 0 units if the calculation stopped early
+	qlonglong order_units_;
+	QString order_instrument_;
+	FixEncoder::Side order_side_;
+	CalcMode order_mode_;
+	// shown instead of clearing the statusbar after a calculation
+	QString calc_notice_;
 	std::map<QString, int> currency_priority_;
+	std::map<QString, std::size_t> instrument_index_;
 };	
 };
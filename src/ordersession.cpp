@@ -0,0 +1,239 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "ordersession.h"
+
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+
+namespace fxcalc {
+	namespace {
+		const int kHeartbeatInterval = 30;
+
+		// text of a field, empty if the tag is missing
+		QString text( const char* message, std::size_t length, const char* tag ) {
+			const char* value = nullptr;
+			std::size_t value_length = 0;
+			if ( ! FixEncoder::field( message, length, tag, &value, &value_length ) ) return QString();
+			return QString::fromLatin1( value, static_cast<int>( value_length ) );
+		}
+
+		// single character field like ExecType, 0 if the tag is missing
+		char flag( const char* message, std::size_t length, const char* tag ) {
+			const char* value = nullptr;
+			std::size_t value_length = 0;
+			if ( ! FixEncoder::field( message, length, tag, &value, &value_length ) || value_length != 1 ) return 0;
+			return *value;
+		}
+	}
+
+	OrderSession::OrderSession(QObject* parent): QObject(parent),
+		epoch_offset_(0), seq_num_(1),
+		next_cl_ord_id_( static_cast<std::uint64_t>( QDateTime::currentMSecsSinceEpoch() ) * 1000 ), logged_on_(false) {
+		sent_at_.fill( 0 );
+		read_buffer_.reserve( 64 * 1024 );
+
+		connect( &socket_, &QTcpSocket::connected, this, &OrderSession::onConnected );
+		connect( &socket_, &QTcpSocket::readyRead, this, &OrderSession::onReadyRead );
+		heartbeat_timer_.setInterval( kHeartbeatInterval * 1000 );
+		connect( &heartbeat_timer_, &QTimer::timeout, this, [this]() {
+			send( encoder_->heartbeat( seq_num_, now() ) );
+		});
+
+		connect( &socket_, &QTcpSocket::disconnected, this, [this]() {
+			logged_on_ = false;
+			heartbeat_timer_.stop();
+			emit status( tr("Order session disconnected.") );
+		});
+		connect( &socket_, static_cast<void (QTcpSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::error), this, [this]() {
+			emit status( tr("Order session: %1").arg( socket_.errorString() ) );
+		});
+	}
+
+	void OrderSession::open( const QString& acceptor, const QString& sender_comp_id, const QString& target_comp_id ) {
+		close();
+
+		QRegularExpression re("^(?<host>[^:]+):(?<port>\\d+)$");
+		QRegularExpressionMatch match = re.match( acceptor );
+		if ( ! match.hasMatch() ) {
+			emit status( tr("Order session needs the acceptor as host:port.") );
+			return;
+		}
+
+		encoder_.reset( new FixEncoder( sender_comp_id.toStdString(), target_comp_id.toStdString() ) );
+		seq_num_ = 1;
+
+		clock_.start();
+		epoch_offset_ = QDateTime::currentMSecsSinceEpoch();
+
+		socket_.connectToHost( match.captured("host"), match.captured("port").toUShort() );
+	}
+
+	void OrderSession::close() {
+		if ( logged_on_ ) {
+			send( encoder_->logout( seq_num_, now() ) );
+			socket_.flush();
+		}
+		logged_on_ = false;
+		heartbeat_timer_.stop();
+		socket_.abort();
+		read_buffer_.clear();
+	}
+
+	bool OrderSession::isOpen() const {
+		return logged_on_;
+	}
+
+	// wall clock in milliseconds, derived from a monotonic clock
+	std::int64_t OrderSession::now() const {
+		return epoch_offset_ + clock_.elapsed();
+	}
+
+	// length 0 is a message the encoder couldn't fit, nothing is sent
+	bool OrderSession::send( std::size_t length ) {
+		if ( length == 0 ) return false;
+		socket_.write( encoder_->data(), static_cast<qint64>( length ) );
+		++seq_num_;
+		return true;
+	}
+
+	void OrderSession::onConnected() {
+		socket_.setSocketOption( QAbstractSocket::LowDelayOption, 1 );
+		if ( ! send( encoder_->logon( seq_num_, kHeartbeatInterval, true, now() ) ) ) {
+			close();
+			emit status( tr("Order session: SenderCompID and TargetCompID are too long.") );
+			return;
+		}
+		heartbeat_timer_.start();
+		emit status( tr("Order session connected, logging on.") );
+	}
+
+	std::uint64_t OrderSession::sendOrder( const QString& symbol, FixEncoder::Side side, std::int64_t units ) {
+		if ( ! logged_on_ ) {
+			emit status( tr("Order session is not logged on.") );
+			return 0;
+		}
+		if ( units <= 0 ) return 0;
+
+		// symbols are short, keep them on the stack
+		char symbol_text[16] = { 0 };
+		for ( int i = 0; i < symbol.size() && i < static_cast<int>( sizeof( symbol_text ) ) - 1; ++i ) {
+			symbol_text[i] = symbol.at( i ).toLatin1();
+		}
+
+		std::uint64_t cl_ord_id = next_cl_ord_id_;
+		std::size_t length = encoder_->newOrderSingle( seq_num_, cl_ord_id, symbol_text, side, units, now() );
+		if ( length == 0 ) {
+			emit status( tr("Order for %1 doesn't fit into a FIX message.").arg( symbol ) );
+			return 0;
+		}
+
+		++next_cl_ord_id_;
+		sent_at_[cl_ord_id % kPendingOrders] = clock_.nsecsElapsed();
+		send( length );
+		return cl_ord_id;
+	}
+
+	void OrderSession::onReadyRead() {
+		read_buffer_.append( socket_.readAll() );
+
+		int offset = 0;
+		int dropped = 0;
+		while ( true ) {
+			// skip anything in front of the next message start
+			int garbage = static_cast<int>( FixEncoder::garbageLength( read_buffer_.constData() + offset, read_buffer_.size() - offset ) );
+			offset  += garbage;
+			dropped += garbage;
+
+			std::size_t length = FixEncoder::messageLength( read_buffer_.constData() + offset, read_buffer_.size() - offset );
+			if ( length == 0 ) break;
+			const char* message = read_buffer_.constData() + offset;
+			offset += static_cast<int>( length );
+
+			const char* value = nullptr;
+			std::size_t value_length = 0;
+			switch ( flag( message, length, "35" ) ) {
+			case 'A':
+				logged_on_ = true;
+				emit status( tr("Order session logged on.") );
+				emit loggedOn();
+				break;
+			case '1':
+				// TestRequest, the heartbeat has to carry its TestReqID
+				if ( FixEncoder::field( message, length, "112", &value, &value_length ) ) {
+					send( encoder_->heartbeat( seq_num_, value, value_length, now() ) );
+				}
+				break;
+			case '3':
+				emit status( tr("Order session: message %1 rejected: %2")
+					.arg( text( message, length, "45" ) ).arg( text( message, length, "58" ) ) );
+				break;
+			case '5':
+				// confirm the logout and let the acceptor close the connection
+				if ( logged_on_ ) {
+					send( encoder_->logout( seq_num_, now() ) );
+				}
+				logged_on_ = false;
+				heartbeat_timer_.stop();
+				emit status( tr("Order session logged out: %1").arg( text( message, length, "58" ) ) );
+				socket_.disconnectFromHost();
+				break;
+			case '8':
+				onExecutionReport( message, length );
+				break;
+			}
+		}
+		read_buffer_.remove( 0, offset );
+
+		if ( dropped > 0 ) {
+			emit status( tr("Order session: dropped %1 bytes that are not FIX.").arg( dropped ) );
+		}
+		// a message start without a parseable header never completes
+		if ( read_buffer_.size() > kMaxMessageSize ) {
+			close();
+			emit status( tr("Order session: message from the acceptor exceeds %1 bytes, disconnected.").arg( kMaxMessageSize ) );
+		}
+	}
+
+	void OrderSession::onExecutionReport( const char* message, std::size_t length ) {
+		const char* value = nullptr;
+		std::size_t value_length = 0;
+		if ( ! FixEncoder::field( message, length, "11", &value, &value_length ) ) return;
+
+		std::uint64_t cl_ord_id = 0;
+		for ( std::size_t i = 0; i < value_length && value[i] >= '0' && value[i] <= '9'; ++i ) {
+			cl_ord_id = cl_ord_id * 10 + static_cast<std::uint64_t>( value[i] - '0' );
+		}
+
+		// ExecType tells what happened, OrdStatus where the order stands
+		char exec_type  = flag( message, length, "150" );
+		char ord_status = flag( message, length, "39" );
+		if ( exec_type == '8' || ord_status == '8' ) {
+			emit orderRejected( cl_ord_id, text( message, length, "58" ) );
+		} else if ( exec_type == 'F' && ord_status == '2' ) {
+			double latency_ms = ( clock_.nsecsElapsed() - sent_at_[cl_ord_id % kPendingOrders] ) / 1e6;
+			emit orderFilled( cl_ord_id, latency_ms );
+		} else if ( exec_type == 'F' ) {
+			emit status( tr("Order %1 partially filled.").arg( cl_ord_id ) );
+		} else if ( exec_type == '0' ) {
+			emit status( tr("Order %1 accepted.").arg( cl_ord_id ) );
+		} else if ( exec_type == '4' || exec_type == 'C' ) {
+			emit status( tr("Order %1 canceled.").arg( cl_ord_id ) );
+		} else {
+			emit status( tr("Order %1: ExecType %2, OrdStatus %3.").arg( cl_ord_id )
+				.arg( QChar( exec_type ) ).arg( QChar( ord_status ) ) );
+		}
+	}
+};
@@ -0,0 +1,85 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "fixencoder.h"
+
+namespace fxcalc {
+	/**
+	 * Persistent FIX session to an acceptor. Logs on when connected and
+	 * sends market orders as NewOrderSingle. Execution reports are
+	 * matched to their orders to measure the round trip latency.
+	 * Sequence numbers are reset on every logon. ClOrdIDs count up from
+	 * the launch time in milliseconds times 1000, a restarted session
+	 * doesn't reuse the IDs of an earlier one.
+	 */
+	class OrderSession: public QObject {
+		Q_OBJECT
+
+	public:
+		OrderSession(QObject* parent = 0);
+
+		// acceptor is given as host:port
+		void open( const QString& acceptor, const QString& sender_comp_id, const QString& target_comp_id );
+		void close();
+		bool isOpen() const;
+
+		// returns the ClOrdID or 0 if the order wasn't sent
+		std::uint64_t sendOrder( const QString& symbol, FixEncoder::Side side, std::int64_t units );
+
+	signals:
+		void status( const QString& message );
+		// the acceptor confirmed the logon, orders can be sent
+		void loggedOn();
+		void orderFilled( std::uint64_t cl_ord_id, double latency_ms );
+		void orderRejected( std::uint64_t cl_ord_id, const QString& reason );
+
+	private slots:
+		void onConnected();
+		void onReadyRead();
+
+	private:
+		static const std::size_t kPendingOrders = 4096;
+		// a partial message longer than this is not FIX, the session is closed
+		static const int kMaxMessageSize = 64 * 1024;
+
+		bool send( std::size_t length );
+		void onExecutionReport( const char* message, std::size_t length );
+		std::int64_t now() const;
+
+		QTcpSocket socket_;
+		std::unique_ptr<FixEncoder> encoder_;
+		QByteArray read_buffer_;
+		QElapsedTimer clock_;
+		QTimer heartbeat_timer_;
+		std::int64_t epoch_offset_;
+		std::uint32_t seq_num_;
+		std::uint64_t next_cl_ord_id_;
+		bool logged_on_;
+		// send time per ClOrdID slot, no allocation per order
+		std::array<std::int64_t, kPendingOrders> sent_at_;
+	};
+};
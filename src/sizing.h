@@ -0,0 +1,85 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+namespace fxcalc {
+	// units per standard lot
+	const double kContractSize = 100000;
+
+	// pip value of a single unit before conversion to the account currency
+	const double kUnitPipCosts = 0.0001;
+
+	/**
+	 * How the quote currency is converted into the account currency.
+	 * NONE if the quote currency is the account currency, ASK if the
+	 * account currency is the base of the conversion pair, BID otherwise.
+	 */
+	enum class Conversion {
+		NONE = 0,
+		ASK,
+		BID
+	};
+
+	// size of one pip in price, instruments quoted in JPY have two decimals
+	inline double pipSize( bool jpy_quote ) {
+		return jpy_quote ? 0.01 : 0.0001;
+	}
+
+	// pip value of a single unit in account currency
+	inline double unitCosts( Conversion conversion, bool jpy_conversion, double current_price ) {
+		double unit_costs = kUnitPipCosts;
+		if ( conversion == Conversion::ASK ) {
+			if ( jpy_conversion ) {
+				unit_costs = unit_costs / ( current_price / 100 );
+			} else {
+				unit_costs = unit_costs / current_price;
+			}
+		} else if ( conversion == Conversion::BID ) {
+			if ( jpy_conversion ) {
+				unit_costs = unit_costs * current_price / 100;
+			} else {
+				unit_costs = unit_costs * current_price;
+			}
+		}
+		return unit_costs;
+	}
+
+	// risk in account currency
+	inline double riskAmount( double account_size, double risk_percent ) {
+		return ( risk_percent * account_size ) / 100;
+	}
+
+	// units to trade so that a stop of sl_pips loses exactly risk
+	inline double unitsForRisk( double risk, double sl_pips, double unit_costs ) {
+		return risk / sl_pips / unit_costs;
+	}
+
+	// margin in account currency required to hold units
+	inline double marginForUnits( double units, double margin_price, double margin_ratio ) {
+		return ( margin_price * units ) / margin_ratio;
+	}
+
+	inline double lotsForUnits( double units ) {
+		return units / kContractSize;
+	}
+
+	// commissions for entry and exit, commission is charged per 1k lot
+	inline double commissionForLots( double lots, double commission ) {
+		if ( commission > 0 ) {
+			return ( ( lots * 100 ) * commission ) * 2;
+		}
+		return 0;
+	}
+};
@@ -0,0 +1,128 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "stress.h"
+#include "sizing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace fxcalc {
+	namespace {
+		// below this many currency evaluations threads cost more than they save
+		const std::size_t kParallelThreshold = 1 << 16;
+	}
+
+	StressTest::StressTest( std::size_t currencies ):
+		currencies_(currencies), exposure_(currencies, 0), margin_(currencies, 0) {}
+
+	void StressTest::addPosition( std::size_t base, std::size_t quote, double units, double price,
+		double quote_rate, double margin_price, double margin_ratio ) {
+		if ( base >= currencies_ || quote >= currencies_ ) return;
+
+		double exposure = units * price * quote_rate;
+		exposure_[base]  += exposure;
+		exposure_[quote] -= exposure;
+		if ( margin_ratio > 0 ) {
+			margin_[base] += marginForUnits( std::fabs( units ), margin_price, margin_ratio );
+		}
+	}
+
+	void StressTest::clear() {
+		std::fill( exposure_.begin(), exposure_.end(), 0.0 );
+		std::fill( margin_.begin(), margin_.end(), 0.0 );
+	}
+
+	std::size_t StressTest::currencies() const {
+		return currencies_;
+	}
+
+	double StressTest::margin() const {
+		double result = 0;
+		for ( std::size_t c = 0; c < currencies_; ++c ) {
+			result += margin_[c];
+		}
+		return result;
+	}
+
+	void StressTest::run( const double* shocks, std::size_t scenarios, double balance,
+		double margin_call_level, double stop_out_level,
+		double* out_equity, double* out_margin, double* out_margin_level, std::uint8_t* out_flags,
+		unsigned threads ) const {
+		if ( threads == 0 ) {
+			threads = std::max( 1u, std::thread::hardware_concurrency() );
+		}
+		if ( scenarios * currencies_ < kParallelThreshold || threads == 1 ) {
+			runRange( shocks, 0, scenarios, balance, margin_call_level, stop_out_level,
+				out_equity, out_margin, out_margin_level, out_flags );
+			return;
+		}
+
+		// scenarios are independent, every thread gets a contiguous range
+		std::vector<std::thread> workers;
+		std::size_t chunk = ( scenarios + threads - 1 ) / threads;
+		std::size_t begin = 0;
+		try {
+			workers.reserve( threads );
+			for ( ; begin < scenarios; begin += chunk ) {
+				std::size_t end = std::min( begin + chunk, scenarios );
+				workers.push_back( std::thread( &StressTest::runRange, this, shocks, begin, end, balance,
+					margin_call_level, stop_out_level, out_equity, out_margin, out_margin_level, out_flags ) );
+			}
+		} catch ( ... ) {
+			// no more threads available, the calling thread takes the rest
+		}
+		if ( begin < scenarios ) {
+			runRange( shocks, begin, scenarios, balance, margin_call_level, stop_out_level,
+				out_equity, out_margin, out_margin_level, out_flags );
+		}
+		for ( std::thread& worker : workers ) {
+			worker.join();
+		}
+	}
+
+	void StressTest::runRange( const double* shocks, std::size_t begin, std::size_t end, double balance,
+		double margin_call_level, double stop_out_level,
+		double* out_equity, double* out_margin, double* out_margin_level, std::uint8_t* out_flags ) const {
+		const double* exposure = exposure_.data();
+		const double* margin   = margin_.data();
+
+		for ( std::size_t s = begin; s < end; ++s ) {
+			const double* shock = shocks + s * currencies_;
+
+			// pnl is sum( exposure * ( f - 1 ) ) = sum( exposure * shock )
+			double pnl          = 0;
+			double margin_total = 0;
+			for ( std::size_t c = 0; c < currencies_; ++c ) {
+				pnl          += exposure[c] * shock[c];
+				margin_total += margin[c] * ( 1 + shock[c] );
+			}
+
+			double equity = balance + pnl;
+			double level  = margin_total > 0 ? equity / margin_total * 100 : HUGE_VAL;
+
+			std::uint8_t flags = 0;
+			if ( margin_total > 0 ) {
+				if ( level < margin_call_level ) flags |= kStressMarginCall;
+				if ( level < stop_out_level ) flags |= kStressStopOut;
+			}
+
+			out_equity[s] = equity;
+			if ( out_margin != nullptr ) out_margin[s] = margin_total;
+			if ( out_margin_level != nullptr ) out_margin_level[s] = level;
+			out_flags[s] = flags;
+		}
+	}
+};
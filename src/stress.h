@@ -0,0 +1,77 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fxcalc {
+	// flags per scenario
+	const std::uint8_t kStressMarginCall = 1;
+	const std::uint8_t kStressStopOut    = 2;
+
+	/**
+	 * Applies price shock scenarios to a portfolio and reports equity,
+	 * margin and margin level per scenario.
+	 *
+	 * A shock is the relative move of a currency against the account
+	 * currency. A position of units base/quote at price gains
+	 * units * price * quote_rate * ( f_base - f_quote ) with f = 1 + shock,
+	 * its margin ( margin_price * units ) / margin_ratio grows with f_base.
+	 * Positions are summed up per currency when they are added, so a
+	 * scenario costs O(currencies) no matter how many positions are held.
+	 */
+	class StressTest {
+	public:
+		explicit StressTest( std::size_t currencies );
+
+		/**
+		 * units are negative for short positions, quote_rate converts one
+		 * unit of the quote currency into the account currency,
+		 * margin_price is the current ask of base/account currency.
+		 * Positions with a currency index out of range are ignored.
+		 */
+		void addPosition( std::size_t base, std::size_t quote, double units, double price,
+			double quote_rate, double margin_price, double margin_ratio );
+		void clear();
+
+		std::size_t currencies() const;
+		// margin of all positions without shocks
+		double margin() const;
+
+		/**
+		 * shocks holds scenarios rows of currencies() values. Results are
+		 * written to caller owned arrays of scenarios values, out_margin
+		 * and out_margin_level may be null. Levels are in percent.
+		 * Large runs are split over threads, 0 uses all cores and 1 runs
+		 * on the calling thread only. If threads can't be started the
+		 * calling thread runs the remaining scenarios.
+		 */
+		void run( const double* shocks, std::size_t scenarios, double balance,
+			double margin_call_level, double stop_out_level,
+			double* out_equity, double* out_margin, double* out_margin_level, std::uint8_t* out_flags,
+			unsigned threads = 0 ) const;
+
+	private:
+		void runRange( const double* shocks, std::size_t begin, std::size_t end, double balance,
+			double margin_call_level, double stop_out_level,
+			double* out_equity, double* out_margin, double* out_margin_level, std::uint8_t* out_flags ) const;
+
+		std::size_t currencies_;
+		std::vector<double> exposure_;  // net notional per currency in account currency
+		std::vector<double> margin_;    // margin per base currency
+	};
+};
@@ -0,0 +1,149 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "tradehistory.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace fxcalc {
+	namespace {
+		// candidates per pass, each pass narrows the interval by kCandidates + 1
+		const int kCandidates = 16;
+		const int kPasses     = 5;
+		// below this many trades per thread threads cost more than they save
+		const std::size_t kMinChunkSize = 1 << 15;
+
+		/**
+		 * Derivative of log terminal wealth sum( x / ( loss + f * x ) ) for
+		 * every candidate f over a range of outcomes.
+		 */
+		void derivatives( const double* begin, const double* end, double loss, const double* f, double* out ) {
+			// one pass over the outcomes, the candidate loop vectorizes
+			double sum[kCandidates] = { 0 };
+			for ( const double* x = begin; x < end; ++x ) {
+				const double value = *x;
+				for ( int k = 0; k < kCandidates; ++k ) {
+					sum[k] += value / ( loss + f[k] * value );
+				}
+			}
+			std::copy( sum, sum + kCandidates, out );
+		}
+	}
+
+	TradeHistory::TradeHistory(): largest_loss_(0), sum_(0) {}
+
+	void TradeHistory::setOutcomes( const std::vector<double>& outcomes ) {
+		outcomes_     = outcomes;
+		largest_loss_ = 0;
+		sum_          = 0;
+		for ( double outcome : outcomes_ ) {
+			largest_loss_ = std::max( largest_loss_, -outcome );
+			sum_         += outcome;
+		}
+	}
+
+	std::size_t TradeHistory::size() const {
+		return outcomes_.size();
+	}
+
+	bool TradeHistory::hasLosses() const {
+		return largest_loss_ > 0;
+	}
+
+	double TradeHistory::kellyRisk() const {
+		std::size_t wins = 0, losses = 0;
+		double win_sum = 0, loss_sum = 0;
+		for ( double outcome : outcomes_ ) {
+			if ( outcome > 0 ) {
+				++wins;
+				win_sum += outcome;
+			} else if ( outcome < 0 ) {
+				++losses;
+				loss_sum -= outcome;
+			}
+		}
+		if ( wins == 0 || losses == 0 ) return 0;
+
+		double win_rate = static_cast<double>( wins ) / outcomes_.size();
+		double payoff   = ( win_sum / wins ) / ( loss_sum / losses );
+		return std::max( 0.0, std::min( 1.0, win_rate - ( 1 - win_rate ) / payoff ) );
+	}
+
+	double TradeHistory::optimalFRisk( unsigned threads ) const {
+		// no edge or no loss to scale f by
+		if ( outcomes_.empty() || sum_ <= 0 || largest_loss_ <= 0 ) return 0;
+
+		if ( threads == 0 ) {
+			threads = std::max( 1u, std::thread::hardware_concurrency() );
+		}
+		std::size_t count = outcomes_.size();
+		threads = static_cast<unsigned>( std::max<std::size_t>( 1, std::min<std::size_t>( threads, count / kMinChunkSize ) ) );
+		std::size_t chunk = ( count + threads - 1 ) / threads;
+
+		// the derivative falls from sum / loss > 0 at f = 0 towards -inf at f = 1,
+		// every pass brackets its root between two neighbouring candidates
+		double low  = 0;
+		double high = 1;
+		std::vector<double> partials( threads * kCandidates );
+		for ( int pass = 0; pass < kPasses; ++pass ) {
+			double f[kCandidates];
+			for ( int k = 0; k < kCandidates; ++k ) {
+				f[k] = low + ( high - low ) * ( k + 1 ) / ( kCandidates + 1 );
+			}
+
+			std::vector<std::thread> workers;
+			unsigned t = 1;
+			try {
+				workers.reserve( threads - 1 );
+				for ( ; t < threads; ++t ) {
+					const double* begin = outcomes_.data() + std::min( count, t * chunk );
+					const double* end   = outcomes_.data() + std::min( count, ( t + 1 ) * chunk );
+					workers.push_back( std::thread( derivatives, begin, end, largest_loss_, f, &partials[t * kCandidates] ) );
+				}
+			} catch ( ... ) {
+				// no more threads available, the calling thread takes the rest
+			}
+			derivatives( outcomes_.data(), outcomes_.data() + std::min( count, chunk ), largest_loss_, f, &partials[0] );
+			for ( ; t < threads; ++t ) {
+				const double* begin = outcomes_.data() + std::min( count, t * chunk );
+				const double* end   = outcomes_.data() + std::min( count, ( t + 1 ) * chunk );
+				derivatives( begin, end, largest_loss_, f, &partials[t * kCandidates] );
+			}
+			for ( std::thread& worker : workers ) {
+				worker.join();
+			}
+
+			// merge per thread sums, then move the bracket
+			double next_low  = f[kCandidates - 1];
+			double next_high = high;
+			for ( int k = 0; k < kCandidates; ++k ) {
+				double sum = 0;
+				for ( unsigned t = 0; t < threads; ++t ) {
+					sum += partials[t * kCandidates + k];
+				}
+				if ( sum < 0 ) {
+					next_low  = k > 0 ? f[k - 1] : low;
+					next_high = f[k];
+					break;
+				}
+			}
+			low  = next_low;
+			high = next_high;
+		}
+
+		// a loss of largest_loss_ R costs f, so one R costs f / largest_loss_
+		return ( low + high ) / 2 / largest_loss_;
+	}
+};
@@ -0,0 +1,54 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fxcalc {
+	/**
+	 * Outcomes of past trades in multiples of the risk taken (R) and the
+	 * risk fraction they suggest for the next trade.
+	 */
+	class TradeHistory {
+	public:
+		TradeHistory();
+
+		void setOutcomes( const std::vector<double>& outcomes );
+		std::size_t size() const;
+		// without losing trades neither fraction is bounded
+		bool hasLosses() const;
+
+		/**
+		 * Kelly fraction W - ( 1 - W ) / ( average win / average loss ),
+		 * the fraction of equity to lose on a -1 R trade. 0 without losses.
+		 */
+		double kellyRisk() const;
+
+		/**
+		 * Optimal f: the fraction f of equity to lose on the largest loss
+		 * that maximizes terminal wealth prod( 1 + f * x / largest loss ).
+		 * Returned as fraction of equity to lose on a -1 R trade, 0 without
+		 * losses. threads 0 uses all cores, ranges without a thread are
+		 * searched on the calling thread.
+		 */
+		double optimalFRisk( unsigned threads = 0 ) const;
+
+	private:
+		std::vector<double> outcomes_;
+		double largest_loss_;
+		double sum_;
+	};
+};
@@ -0,0 +1,127 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "volatility.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fxcalc {
+	RollingWindow::RollingWindow( std::size_t period ): period_( std::max<std::size_t>( period, 1 ) ) {}
+
+	std::size_t RollingWindow::addSeries() {
+		values_.resize( values_.size() + period_, 0 );
+		head_.push_back( 0 );
+		count_.push_back( 0 );
+		sum_.push_back( 0 );
+		sum_sq_.push_back( 0 );
+		return head_.size() - 1;
+	}
+
+	void RollingWindow::push( std::size_t series, double value ) {
+		double& slot = values_[ series * period_ + head_[series] ];
+		if ( count_[series] == period_ ) {
+			// drop the oldest value
+			sum_[series]    -= slot;
+			sum_sq_[series] -= slot * slot;
+		} else {
+			++count_[series];
+		}
+		slot = value;
+		sum_[series]    += value;
+		sum_sq_[series] += value * value;
+
+		if ( ++head_[series] == period_ ) {
+			head_[series] = 0;
+			// once per period rebuild the sums from the ring, rounding
+			// errors of the running updates don't build up on long feeds
+			if ( count_[series] == period_ ) {
+				const double* ring = &values_[ series * period_ ];
+				double sum = 0, sum_sq = 0;
+				for ( std::size_t i = 0; i < period_; ++i ) {
+					sum    += ring[i];
+					sum_sq += ring[i] * ring[i];
+				}
+				sum_[series]    = sum;
+				sum_sq_[series] = sum_sq;
+			}
+		}
+	}
+
+	bool RollingWindow::full( std::size_t series ) const {
+		return count_[series] == period_;
+	}
+
+	double RollingWindow::mean( std::size_t series ) const {
+		if ( count_[series] == 0 ) return 0;
+		return sum_[series] / count_[series];
+	}
+
+	double RollingWindow::stddev( std::size_t series ) const {
+		std::size_t count = count_[series];
+		if ( count < 2 ) return 0;
+		double mean     = sum_[series] / count;
+		double variance = ( sum_sq_[series] - mean * sum_[series] ) / ( count - 1 );
+		// running sums may drift slightly below zero
+		return variance > 0 ? std::sqrt( variance ) : 0;
+	}
+
+	VolatilityEngine::VolatilityEngine( std::size_t period ): true_range_(period), change_(period) {}
+
+	std::size_t VolatilityEngine::addInstrument( double pip_size ) {
+		true_range_.addSeries();
+		change_.addSeries();
+		pip_size_.push_back( pip_size );
+		prev_close_.push_back( 0 );
+		has_prev_close_.push_back( false );
+		return pip_size_.size() - 1;
+	}
+
+	std::size_t VolatilityEngine::size() const {
+		return pip_size_.size();
+	}
+
+	void VolatilityEngine::addBar( std::size_t instrument, double high, double low, double close ) {
+		double true_range = high - low;
+		if ( has_prev_close_[instrument] ) {
+			double prev_close = prev_close_[instrument];
+			true_range = std::max( high, prev_close ) - std::min( low, prev_close );
+			change_.push( instrument, close - prev_close );
+		}
+		true_range_.push( instrument, true_range );
+
+		prev_close_[instrument]     = close;
+		has_prev_close_[instrument] = true;
+	}
+
+	bool VolatilityEngine::ready( std::size_t instrument ) const {
+		return true_range_.full( instrument );
+	}
+
+	double VolatilityEngine::atr( std::size_t instrument ) const {
+		return true_range_.mean( instrument );
+	}
+
+	double VolatilityEngine::stddev( std::size_t instrument ) const {
+		return change_.stddev( instrument );
+	}
+
+	double VolatilityEngine::atrPips( std::size_t instrument ) const {
+		return atr( instrument ) / pip_size_[instrument];
+	}
+
+	double VolatilityEngine::stddevPips( std::size_t instrument ) const {
+		return stddev( instrument ) / pip_size_[instrument];
+	}
+};
@@ -0,0 +1,76 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace fxcalc {
+	/**
+	 * Fixed length rolling windows for many series at once. The values of
+	 * all series live in one contiguous ring buffer, running sums make
+	 * every push and every query O(1) amortized. The sums are recomputed
+	 * from the ring once per period.
+	 */
+	class RollingWindow {
+	public:
+		explicit RollingWindow( std::size_t period );
+
+		// returns the index of the new series
+		std::size_t addSeries();
+		void push( std::size_t series, double value );
+
+		bool full( std::size_t series ) const;
+		double mean( std::size_t series ) const;
+		double stddev( std::size_t series ) const;
+
+	private:
+		std::size_t period_;
+		std::vector<double> values_;       // series * period_
+		std::vector<std::size_t> head_;
+		std::vector<std::size_t> count_;
+		std::vector<double> sum_;
+		std::vector<double> sum_sq_;
+	};
+
+	/**
+	 * Average true range and standard deviation of close to close changes
+	 * for every instrument, updated incrementally bar by bar.
+	 */
+	class VolatilityEngine {
+	public:
+		explicit VolatilityEngine( std::size_t period = 14 );
+
+		// returns the index of the new instrument
+		std::size_t addInstrument( double pip_size );
+		std::size_t size() const;
+
+		void addBar( std::size_t instrument, double high, double low, double close );
+
+		// true once a full period of bars has been seen
+		bool ready( std::size_t instrument ) const;
+		double atr( std::size_t instrument ) const;
+		double stddev( std::size_t instrument ) const;
+		double atrPips( std::size_t instrument ) const;
+		double stddevPips( std::size_t instrument ) const;
+
+	private:
+		RollingWindow true_range_;
+		RollingWindow change_;
+		std::vector<double> pip_size_;
+		std::vector<double> prev_close_;
+		std::vector<bool> has_prev_close_;
+	};
+};
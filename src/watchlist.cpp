@@ -0,0 +1,281 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#include "watchlist.h"
+#include "sizing.h"
+
+#include <QLocale>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+namespace fxcalc {
+	namespace {
+		// one frame at 60 fps
+		const int kFlushInterval = 16;
+
+		// cells differ if they would display differently
+		bool changed( double a, double b ) {
+			return std::fabs( a - b ) > 1e-9 * std::max( 1.0, std::fabs( a ) );
+		}
+	}
+
+	WatchlistModel::WatchlistModel( const std::map<QString, int>& currency_priority, QObject* parent ):
+		QAbstractTableModel(parent),
+		currency_priority_(currency_priority),
+		account_size_(0), risk_percent_(0), sl_pips_(0), margin_ratio_(0) {
+		flush_timer_.setSingleShot( true );
+		flush_timer_.setInterval( kFlushInterval );
+		connect( &flush_timer_, &QTimer::timeout, this, &WatchlistModel::flush );
+	}
+
+	void WatchlistModel::setInstruments( const QStringList& instruments ) {
+		beginResetModel();
+		instruments_ = instruments;
+		Result empty = { 0, 0, 0, 0, false, false };
+		results_.assign( instruments_.size(), empty );
+		dirty_.assign( instruments_.size(), 0 );
+		dirty_rows_.clear();
+		rebuildDependencies();
+		endResetModel();
+
+		for ( int row = 0; row < instruments_.size(); ++row ) {
+			markDirty( row );
+		}
+	}
+
+	void WatchlistModel::setInputs( double account_size, double risk_percent, double sl_pips, double margin_ratio, const QString& account_currency ) {
+		bool currency_changed = account_currency != account_currency_;
+		if ( ! currency_changed && account_size == account_size_ && risk_percent == risk_percent_
+			&& sl_pips == sl_pips_ && margin_ratio == margin_ratio_ ) {
+			return;
+		}
+
+		account_size_     = account_size;
+		risk_percent_     = risk_percent;
+		sl_pips_          = sl_pips;
+		margin_ratio_     = margin_ratio;
+		account_currency_ = account_currency;
+		if ( currency_changed ) {
+			rebuildDependencies();
+			// the currency suffix changes even if the values don't
+			if ( ! instruments_.isEmpty() ) {
+				emit dataChanged( index( 0, PIP_VALUE ), index( instruments_.size() - 1, MARGIN ), QVector<int>() << Qt::DisplayRole );
+			}
+		}
+
+		// every row depends on the inputs
+		for ( int row = 0; row < instruments_.size(); ++row ) {
+			markDirty( row );
+		}
+	}
+
+	void WatchlistModel::setRate( const QString& pair, double price ) {
+		auto it = rates_.find( pair );
+		if ( it != rates_.end() && it.value() == price ) return;
+		rates_[pair] = price;
+
+		auto rows = rate_rows_.constFind( pair );
+		if ( rows == rate_rows_.constEnd() ) return;
+		for ( int row : rows.value() ) {
+			markDirty( row );
+		}
+	}
+
+	void WatchlistModel::markDirty( int row ) {
+		if ( dirty_[row] ) return;
+		dirty_[row] = 1;
+		dirty_rows_.push_back( row );
+		if ( ! flush_timer_.isActive() ) {
+			flush_timer_.start();
+		}
+	}
+
+	// which rows use the price of which pair, depends on the account currency
+	void WatchlistModel::rebuildDependencies() {
+		rate_rows_.clear();
+		for ( int row = 0; row < instruments_.size(); ++row ) {
+			QString base  = instruments_[row].left( 3 );
+			QString quote = instruments_[row].mid( 3, 3 );
+
+			QStringList pairs;
+			pairs << base + account_currency_ << account_currency_ + base;
+			pairs << quote + account_currency_ << account_currency_ + quote;
+			for ( const QString& pair : pairs ) {
+				std::vector<int>& rows = rate_rows_[pair];
+				if ( rows.empty() || rows.back() != row ) {
+					rows.push_back( row );
+				}
+			}
+		}
+	}
+
+	// price of base/quote, inverted from quote/base if only that is known
+	bool WatchlistModel::rate( const QString& base, const QString& quote, double* price ) const {
+		auto it = rates_.constFind( base + quote );
+		if ( it != rates_.constEnd() && it.value() > 0 ) {
+			*price = it.value();
+			return true;
+		}
+		it = rates_.constFind( quote + base );
+		if ( it != rates_.constEnd() && it.value() > 0 ) {
+			*price = 1 / it.value();
+			return true;
+		}
+		return false;
+	}
+
+	// same rules as MainWindow::calculate()
+	WatchlistModel::Result WatchlistModel::compute( int row ) const {
+		Result result = { 0, 0, 0, 0, false, false };
+		if ( sl_pips_ <= 0 ) return result;
+
+		QString base_currency  = instruments_[row].left( 3 );
+		QString quote_currency = instruments_[row].mid( 3, 3 );
+
+		Conversion conversion = Conversion::NONE;
+		bool jpy_conversion   = false;
+		double current_price  = 1;
+		if ( quote_currency != account_currency_ ) {
+			auto account_priority = currency_priority_.find( account_currency_ );
+			auto quote_priority   = currency_priority_.find( quote_currency );
+			int account_value     = account_priority == currency_priority_.end() ? 0 : account_priority->second;
+			int quote_value       = quote_priority == currency_priority_.end() ? 0 : quote_priority->second;
+
+			QString base_aff_currency  = quote_currency;
+			QString quote_aff_currency = account_currency_;
+			if ( account_value > quote_value || quote_value == 0 ) {
+				base_aff_currency  = account_currency_;
+				quote_aff_currency = quote_currency;
+			}
+
+			if ( ! rate( base_aff_currency, quote_aff_currency, &current_price ) ) return result;
+			conversion     = account_currency_ == base_aff_currency ? Conversion::ASK : Conversion::BID;
+			jpy_conversion = quote_aff_currency == "JPY";
+		}
+
+		double unit_costs = unitCosts( conversion, jpy_conversion, current_price );
+		result.units      = unitsForRisk( riskAmount( account_size_, risk_percent_ ), sl_pips_, unit_costs );
+		result.lots       = lotsForUnits( result.units );
+		result.pip_value  = unit_costs * kContractSize;
+		result.valid      = true;
+
+		double margin_price = 1;
+		if ( margin_ratio_ > 0 && ( base_currency == account_currency_ || rate( base_currency, account_currency_, &margin_price ) ) ) {
+			result.margin     = marginForUnits( result.units, margin_price, margin_ratio_ );
+			result.has_margin = true;
+		}
+		return result;
+	}
+
+	// recompute dirty rows and report changed cells. Consecutive rows with
+	// the same changed columns share a signal per contiguous column range.
+	void WatchlistModel::flush() {
+		std::sort( dirty_rows_.begin(), dirty_rows_.end() );
+
+		int run_first = -1;
+		int run_last  = -1;
+		unsigned run_columns = 0;  // bit per changed column
+		auto emitRun = [&]() {
+			for ( int column = 0; column < COLUMN_COUNT; ++column ) {
+				if ( ! ( run_columns & ( 1u << column ) ) ) continue;
+				int column_last = column;
+				while ( column_last + 1 < COLUMN_COUNT && ( run_columns & ( 1u << ( column_last + 1 ) ) ) ) {
+					++column_last;
+				}
+				emit dataChanged( index( run_first, column ), index( run_last, column_last ), QVector<int>() << Qt::DisplayRole );
+				column = column_last;
+			}
+			run_first   = -1;
+			run_columns = 0;
+		};
+
+		for ( int row : dirty_rows_ ) {
+			dirty_[row] = 0;
+
+			Result result = compute( row );
+			Result& old   = results_[row];
+
+			unsigned columns   = 0;
+			bool valid_changed = result.valid != old.valid;
+			if ( valid_changed || changed( result.units, old.units ) ) columns |= 1u << UNITS;
+			if ( valid_changed || changed( result.lots, old.lots ) ) columns |= 1u << LOTS;
+			if ( valid_changed || changed( result.pip_value, old.pip_value ) ) columns |= 1u << PIP_VALUE;
+			if ( result.has_margin != old.has_margin || changed( result.margin, old.margin ) ) columns |= 1u << MARGIN;
+			old = result;
+
+			if ( columns == 0 ) continue;
+			if ( run_first < 0 || row != run_last + 1 || columns != run_columns ) {
+				emitRun();
+				run_first   = row;
+				run_columns = columns;
+			}
+			run_last = row;
+		}
+		emitRun();
+
+		dirty_rows_.clear();
+	}
+
+	int WatchlistModel::rowCount( const QModelIndex& parent ) const {
+		return parent.isValid() ? 0 : instruments_.size();
+	}
+
+	int WatchlistModel::columnCount( const QModelIndex& parent ) const {
+		return parent.isValid() ? 0 : COLUMN_COUNT;
+	}
+
+	QVariant WatchlistModel::data( const QModelIndex& index, int role ) const {
+		if ( ! index.isValid() || index.row() >= instruments_.size() ) return QVariant();
+
+		if ( role == Qt::TextAlignmentRole ) {
+			if ( index.column() == INSTRUMENT ) return QVariant();
+			return int( Qt::AlignRight | Qt::AlignVCenter );
+		}
+		if ( role != Qt::DisplayRole ) return QVariant();
+
+		const Result& result = results_[index.row()];
+		switch ( index.column() ) {
+			case INSTRUMENT:
+				return instruments_[index.row()];
+			case UNITS:
+				if ( ! result.valid ) return QString("-");
+				return QString::number( result.units, 'f', 0 );
+			case LOTS:
+				if ( ! result.valid ) return QString("-");
+				return QLocale::system().toString( result.lots, 'f', 3 );
+			case PIP_VALUE:
+				if ( ! result.valid ) return QString("-");
+				return QLocale::system().toString( result.pip_value, 'f', 2 ) + " " + account_currency_;
+			case MARGIN:
+				if ( ! result.has_margin ) return QString("-");
+				return QLocale::system().toString( result.margin, 'f', 2 ) + " " + account_currency_;
+		}
+		return QVariant();
+	}
+
+	QVariant WatchlistModel::headerData( int section, Qt::Orientation orientation, int role ) const {
+		if ( role != Qt::DisplayRole || orientation != Qt::Horizontal ) return QVariant();
+
+		switch ( section ) {
+			case INSTRUMENT: return tr("Instrument");
+			case UNITS:      return tr("Units");
+			case LOTS:       return tr("Lots");
+			case PIP_VALUE:  return tr("Pip Value");
+			case MARGIN:     return tr("Margin");
+		}
+		return QVariant();
+	}
+};
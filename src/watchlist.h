@@ -0,0 +1,91 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <map>
+#include <vector>
+
+namespace fxcalc {
+	/**
+	 * Position size of every instrument at the current inputs. Results
+	 * live in one contiguous array, changed inputs or rates only mark the
+	 * affected rows dirty. Dirty rows are recomputed in one batch per
+	 * frame and only cells whose value changed are reported.
+	 */
+	class WatchlistModel: public QAbstractTableModel {
+		Q_OBJECT
+
+	public:
+		enum Column {
+			INSTRUMENT = 0,
+			UNITS,
+			LOTS,
+			PIP_VALUE,
+			MARGIN,
+			COLUMN_COUNT
+		};
+
+		WatchlistModel( const std::map<QString, int>& currency_priority, QObject* parent = 0 );
+
+		void setInstruments( const QStringList& instruments );
+		void setInputs( double account_size, double risk_percent, double sl_pips, double margin_ratio, const QString& account_currency );
+		// current price of a currency pair
+		void setRate( const QString& pair, double price );
+
+		int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+		int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+		QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+		QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
+
+	private slots:
+		void flush();
+
+	private:
+		struct Result {
+			double units;
+			double lots;
+			double pip_value;
+			double margin;
+			bool valid;
+			bool has_margin;
+		};
+
+		void markDirty( int row );
+		void rebuildDependencies();
+		bool rate( const QString& base, const QString& quote, double* price ) const;
+		Result compute( int row ) const;
+
+		std::map<QString, int> currency_priority_;
+		QStringList instruments_;
+		std::vector<Result> results_;
+		std::vector<char> dirty_;
+		std::vector<int> dirty_rows_;
+		QHash<QString, double> rates_;
+		QHash<QString, std::vector<int>> rate_rows_;  // pair => rows using its price
+		QTimer flush_timer_;
+
+		double account_size_;
+		double risk_percent_;
+		double sl_pips_;
+		double margin_ratio_;
+		QString account_currency_;
+	};
+};
@@ -0,0 +1,47 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+// Minimal checks for the unit tests, a failed check is printed and
+// makes the test exit with a non zero status.
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+namespace fxcalc {
+	namespace test {
+		inline int& failures() {
+			static int count = 0;
+			return count;
+		}
+
+		inline void check( bool ok, const char* expression, const char* file, int line ) {
+			if ( ok ) return;
+			std::printf( "%s:%d: check failed: %s\n", file, line, expression );
+			++failures();
+		}
+
+		inline void checkNear( double actual, double expected, double tolerance, const char* expression, const char* file, int line ) {
+			if ( std::fabs( actual - expected ) <= tolerance ) return;
+			std::printf( "%s:%d: check failed: %s, %.10g != %.10g\n", file, line, expression, actual, expected );
+			++failures();
+		}
+	};
+};
+
+#define CHECK( expression ) fxcalc::test::check( ( expression ), #expression, __FILE__, __LINE__ )
+#define CHECK_NEAR( actual, expected, tolerance ) \
+	fxcalc::test::checkNear( ( actual ), ( expected ), ( tolerance ), #actual, __FILE__, __LINE__ )
+#define TEST_RESULT() ( fxcalc::test::failures() == 0 ? 0 : 1 )
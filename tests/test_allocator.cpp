@@ -0,0 +1,116 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "allocator.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace fxcalc;
+
+namespace {
+	// EURUSD on a USD account: 10 USD per pip and lot
+	OrderRequest order( double target_risk, double sl_pips, double lot_step ) {
+		OrderRequest request;
+		request.target_risk  = target_risk;
+		request.sl_pips      = sl_pips;
+		request.unit_costs   = 0.0001;
+		request.margin_price = 1.1;
+		request.min_lot      = lot_step;
+		request.lot_step     = lot_step;
+		request.max_lot      = 0;
+		return request;
+	}
+
+	bool onStep( double lots, double lot_step ) {
+		double steps = lots / lot_step;
+		return std::fabs( steps - std::round( steps ) ) < 1e-6;
+	}
+
+	void testEveryOrderFits() {
+		std::vector<OrderRequest> orders;
+		orders.push_back( order( 500, 20, 0.01 ) );   // 2.5 lots
+		orders.push_back( order( 60, 20, 0.1 ) );     // 0.3 lots, 0.3 / 0.1 isn't exact
+		orders.push_back( order( 100, 30, 0.01 ) );   // 0.333.. lots
+
+		AllocationResult result = LotAllocator( 1e6, 30 ).allocate( orders );
+		CHECK_NEAR( result.allocations[0].lots, 2.5, 1e-9 );
+		CHECK_NEAR( result.allocations[1].lots, 0.3, 1e-9 );
+		CHECK_NEAR( result.allocations[2].lots, 0.33, 1e-9 );
+		for ( std::size_t i = 0; i < orders.size(); ++i ) {
+			CHECK( onStep( result.allocations[i].lots, orders[i].lot_step ) );
+			CHECK( result.allocations[i].risk <= orders[i].target_risk + 1e-6 );
+		}
+		CHECK_NEAR( result.allocations[0].margin, 2.5 * 100000 * 1.1 / 30, 1e-6 );
+		CHECK( result.total_risk <= result.risk_bound + 1e-6 );
+	}
+
+	void testMarginShortage() {
+		// per lot 100 and 200 risk, both need 3666.67 margin
+		std::vector<OrderRequest> orders;
+		orders.push_back( order( 200, 10, 0.01 ) );
+		orders.push_back( order( 400, 20, 0.01 ) );
+
+		double free_margin = 5000;
+		AllocationResult result = LotAllocator( free_margin, 30 ).allocate( orders );
+		CHECK( result.total_margin <= free_margin + 1e-6 );
+		CHECK( result.total_risk <= result.risk_bound + 1e-6 );
+		// the order with more risk per margin is filled first
+		CHECK_NEAR( result.allocations[1].lots, 1.36, 1e-9 );
+		CHECK_NEAR( result.allocations[0].lots, 0, 1e-12 );
+		CHECK( onStep( result.allocations[1].lots, 0.01 ) );
+	}
+
+	void testLotLimits() {
+		std::vector<OrderRequest> orders;
+		orders.push_back( order( 500, 20, 0.01 ) );
+		orders.back().max_lot = 1;
+		orders.push_back( order( 5, 20, 0.01 ) );
+		orders.back().min_lot = 0.1;
+
+		AllocationResult result = LotAllocator( 1e6, 30 ).allocate( orders );
+		CHECK_NEAR( result.allocations[0].lots, 1, 1e-9 );
+		CHECK_NEAR( result.allocations[1].lots, 0, 1e-12 );
+	}
+
+	void testInvalidOrders() {
+		std::vector<OrderRequest> orders;
+		orders.push_back( order( 500, 0, 0.01 ) );
+		orders.push_back( order( 500, 20, 0 ) );
+		orders.push_back( order( 500, 20, 0.01 ) );
+		orders.back().margin_price = 0;
+		orders.push_back( order( 500, 20, 0.01 ) );
+
+		AllocationResult result = LotAllocator( 1e6, 30 ).allocate( orders );
+		for ( std::size_t i = 0; i < 3; ++i ) {
+			CHECK( result.allocations[i].lots == 0 );
+		}
+		CHECK_NEAR( result.allocations[3].lots, 2.5, 1e-9 );
+
+		// without a margin ratio the margin price doesn't matter
+		result = LotAllocator( 0, 0 ).allocate( orders );
+		CHECK_NEAR( result.allocations[2].lots, 2.5, 1e-9 );
+		CHECK_NEAR( result.total_margin, 0, 1e-12 );
+	}
+};
+
+int main() {
+	testEveryOrderFits();
+	testMarginShortage();
+	testLotLimits();
+	testInvalidOrders();
+	return TEST_RESULT();
+}
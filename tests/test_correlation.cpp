@@ -0,0 +1,109 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "correlation.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace fxcalc;
+
+namespace {
+	const std::size_t kPeriod = 10;
+
+	// instrument 1 moves with 0, instrument 2 against it
+	CorrelationMatrix correlatedMatrix( std::vector<std::vector<double>>* rows ) {
+		CorrelationMatrix matrix( kPeriod );
+		matrix.resize( 3 );
+		for ( std::size_t k = 0; k < 2 * kPeriod + 3; ++k ) {
+			double r = std::sin( k * 1.7 ) * 0.001;
+			std::vector<double> row = { r, 2 * r, -r };
+			matrix.addReturns( row.data() );
+			rows->push_back( row );
+		}
+		return matrix;
+	}
+
+	void testCovariance() {
+		std::vector<std::vector<double>> rows;
+		CorrelationMatrix matrix = correlatedMatrix( &rows );
+		CHECK( matrix.ready() );
+
+		// compare with the sample covariance of the last period rows
+		for ( std::size_t i = 0; i < 3; ++i ) {
+			for ( std::size_t j = 0; j < 3; ++j ) {
+				double mean_i = 0, mean_j = 0;
+				for ( std::size_t k = rows.size() - kPeriod; k < rows.size(); ++k ) {
+					mean_i += rows[k][i] / kPeriod;
+					mean_j += rows[k][j] / kPeriod;
+				}
+				double expected = 0;
+				for ( std::size_t k = rows.size() - kPeriod; k < rows.size(); ++k ) {
+					expected += ( rows[k][i] - mean_i ) * ( rows[k][j] - mean_j ) / ( kPeriod - 1 );
+				}
+				CHECK_NEAR( matrix.covariance( i, j ), expected, 1e-12 );
+			}
+		}
+
+		CHECK_NEAR( matrix.correlation( 0, 1 ), 1, 1e-9 );
+		CHECK_NEAR( matrix.correlation( 0, 2 ), -1, 1e-9 );
+	}
+
+	void testCloses() {
+		CorrelationMatrix matrix( 2 );
+		matrix.resize( 1 );
+		// a second close of an instrument commits the row of the first
+		matrix.addClose( 0, 1.0 );
+		matrix.addClose( 0, 1.1 );
+		matrix.addClose( 0, 1.21 );
+		CHECK( matrix.ready() );
+		CHECK_NEAR( matrix.covariance( 0, 0 ), 0.005, 1e-12 );
+	}
+
+	void testMaxAdditionalRisk() {
+		std::vector<std::vector<double>> rows;
+		CorrelationMatrix matrix = correlatedMatrix( &rows );
+		const double cap = 100;
+
+		// nothing open, the whole cap is available
+		std::vector<double> open_risk( 3, 0 );
+		CHECK_NEAR( matrix.maxAdditionalRisk( open_risk, 1, 1, cap ), cap, 1e-9 );
+
+		// 50 long on a perfectly correlated instrument leaves 50, a short
+		// position may go 100 beyond the hedge
+		open_risk[0] = 50;
+		CHECK_NEAR( matrix.maxAdditionalRisk( open_risk, 1, 1, cap ), 50, 1e-6 );
+		CHECK_NEAR( matrix.maxAdditionalRisk( open_risk, 1, -1, cap ), 150, 1e-6 );
+		CHECK_NEAR( matrix.maxAdditionalRisk( open_risk, 2, 1, cap ), 150, 1e-6 );
+
+		// a book above the cap leaves nothing, not even for a hedge
+		open_risk[0] = 150;
+		CHECK( matrix.maxAdditionalRisk( open_risk, 1, 1, cap ) == 0 );
+		CHECK( matrix.maxAdditionalRisk( open_risk, 2, 1, cap ) == 0 );
+		open_risk[0] = cap;
+		CHECK( matrix.maxAdditionalRisk( open_risk, 2, 1, cap ) == 0 );
+
+		CHECK( matrix.maxAdditionalRisk( open_risk, 3, 1, cap ) == 0 );
+		CHECK( matrix.maxAdditionalRisk( open_risk, 1, 1, 0 ) == 0 );
+	}
+};
+
+int main() {
+	testCovariance();
+	testCloses();
+	testMaxAdditionalRisk();
+	return TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "check.h"
+#include "fixencoder.h"
+
+#include <cstring>
+#include <string>
+
+using namespace fxcalc;
+
+namespace {
+	// 2023-11-14 22:13:20.000 UTC
+	const std::int64_t kTime = 1700000000000;
+
+	std::string message( const FixEncoder& encoder, std::size_t length ) {
+		return std::string( encoder.data(), length );
+	}
+
+	std::string value( const std::string& text, const char* tag ) {
+		const char* found = nullptr;
+		std::size_t found_length = 0;
+		if ( ! FixEncoder::field( text.data(), text.size(), tag, &found, &found_length ) ) return "<missing>";
+		return std::string( found, found_length );
+	}
+
+	// BodyLength and CheckSum of an encoded message
+	void checkFraming( const std::string& text ) {
+		CHECK( text.compare( 0, 10, "8=FIX.4.4\x01" ) == 0 );
+
+		std::size_t body_begin = text.find( '\x01', 10 ) + 1;
+		std::size_t trailer    = text.size() - 7;
+		CHECK( std::stoul( value( text, "9" ) ) == trailer - body_begin );
+
+		unsigned checksum = 0;
+		for ( std::size_t i = 0; i < trailer; ++i ) {
+			checksum += static_cast<unsigned char>( text[i] );
+		}
+		CHECK( text.compare( trailer, 3, "10=" ) == 0 );
+		CHECK( std::stoul( text.substr( trailer + 3, 3 ) ) == checksum % 256 );
+		CHECK( text.back() == '\x01' );
+		CHECK( FixEncoder::messageLength( text.data(), text.size() ) == text.size() );
+	}
+
+	void testNewOrderSingle() {
+		FixEncoder encoder( "FXCALC", "BROKER" );
+		std::size_t length = encoder.newOrderSingle( 7, 1700000000000000ull, "EURUSD", FixEncoder::BUY, 100000, kTime );
+		std::string text = message( encoder, length );
+
+		CHECK( text == std::string( "8=FIX.4.4\x01" "9=130\x01" "35=D\x01" "49=FXCALC\x01" "56=BROKER\x01" "34=7\x01"
+			"52=20231114-22:13:20.000\x01" "11=1700000000000000\x01" "55=EURUSD\x01" "54=1\x01"
+			"60=20231114-22:13:20.000\x01" "38=100000\x01" "40=1\x01" "10=208\x01" ) );
+		checkFraming( text );
+	}
+
+	void testSessionMessages() {
+		FixEncoder encoder( "FXCALC", "BROKER" );
+
+		std::string logon = message( encoder, encoder.logon( 1, 30, true, kTime ) );
+		checkFraming( logon );
+		CHECK( value( logon, "35" ) == "A" );
+		CHECK( value( logon, "34" ) == "1" );
+		CHECK( value( logon, "108" ) == "30" );
+		CHECK( value( logon, "141" ) == "Y" );
+		CHECK( value( message( encoder, encoder.logon( 1, 30, false, kTime ) ), "141" ) == "<missing>" );
+
+		std::string heartbeat = message( encoder, encoder.heartbeat( 12, "PING", 4, kTime ) );
+		checkFraming( heartbeat );
+		CHECK( value( heartbeat, "35" ) == "0" );
+		CHECK( value( heartbeat, "112" ) == "PING" );
+		CHECK( value( message( encoder, encoder.heartbeat( 13, kTime ) ), "112" ) == "<missing>" );
+
+		std::string logout = message( encoder, encoder.logout( 14, kTime ) );
+		checkFraming( logout );
+		CHECK( value( logout, "35" ) == "5" );
+		CHECK( value( logout, "34" ) == "14" );
+	}
+
+	void testTimestamp() {
+		FixEncoder encoder( "A", "B" );
+		// leap day, before the epoch
+		CHECK( value( message( encoder, encoder.heartbeat( 1, 951868799999 ) ), "52" ) == "20000229-23:59:59.999" );
+		CHECK( value( message( encoder, encoder.heartbeat( 1, -1 ) ), "52" ) == "19691231-23:59:59.999" );
+	}
+
+	void testExecutionReport() {
+		FixEncoder encoder( "BROKER", "FXCALC" );
+		std::string text = message( encoder, encoder.executionReport( 3, "42", 2, "GBPJPY", 6, '2', 5000, kTime ) );
+		checkFraming( text );
+		CHECK( value( text, "11" ) == "42" );
+		CHECK( value( text, "150" ) == "F" );
+		CHECK( value( text, "39" ) == "2" );
+		CHECK( value( text, "54" ) == "2" );
+		CHECK( value( text, "14" ) == "5000" );
+		// tags are matched whole, 1 is not the start of 11 or 14
+		CHECK( value( text, "1" ) == "<missing>" );
+	}
+
+	void testOverflow() {
+		FixEncoder encoder( std::string( 2000, 'S' ), "B" );
+		CHECK( encoder.logon( 1, 30, true, kTime ) == 0 );
+
+		// the buffer is reused, a failed message doesn't break the next one
+		FixEncoder small( "A", "B" );
+		std::string symbol( 1100, 'X' );
+		CHECK( small.newOrderSingle( 1, 1, symbol.c_str(), FixEncoder::SELL, 1, kTime ) == 0 );
+		checkFraming( message( small, small.newOrderSingle( 2, 2, "EURUSD", FixEncoder::SELL, 1, kTime ) ) );
+	}
+
+	void testStreamParsing() {
+		FixEncoder encoder( "FXCALC", "BROKER" );
+		std::string first  = message( encoder, encoder.heartbeat( 1, kTime ) );
+		std::string second = message( encoder, encoder.logout( 2, kTime ) );
+		std::string stream = "junk\x01" "9=3\x01" + first + second;
+
+		std::size_t garbage = FixEncoder::garbageLength( stream.data(), stream.size() );
+		CHECK( garbage == 9 );
+		CHECK( FixEncoder::messageLength( stream.data() + garbage, stream.size() - garbage ) == first.size() );
+		std::size_t offset = garbage + first.size();
+		CHECK( FixEncoder::garbageLength( stream.data() + offset, stream.size() - offset ) == 0 );
+		CHECK( FixEncoder::messageLength( stream.data() + offset, stream.size() - offset ) == second.size() );
+
+		// incomplete messages wait for more data
+		for ( std::size_t size = 0; size < first.size(); ++size ) {
+			CHECK( FixEncoder::messageLength( first.data(), size ) == 0 );
+		}
+		// a cut off start is kept, it may complete with the next read
+		CHECK( FixEncoder::garbageLength( "abc8=F", 6 ) == 3 );
+		CHECK( FixEncoder::garbageLength( "abc8=X", 6 ) == 6 );
+		CHECK( FixEncoder::garbageLength( "", 0 ) == 0 );
+	}
+}
+
+int main() {
+	testNewOrderSingle();
+	testSessionMessages();
+	testTimestamp();
+	testExecutionReport();
+	testOverflow();
+	testStreamParsing();
+	return TEST_RESULT();
+}
@@ -0,0 +1,135 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "journal.h"
+
+#include <string>
+
+using namespace fxcalc;
+
+namespace {
+	JournalSettings settings() {
+		JournalSettings result;
+		result.balance      = 10000;
+		result.risk_percent = 1;
+		result.commission   = 0;
+		return result;
+	}
+
+	// 0.2 lots with a 50 pip stop risk exactly 1 % of 10000
+	const char* kWin  = "EURUSD,0.2,1.1000,1.1050,1.0950,100\n";
+	const char* kLoss = "EURUSD,0.2,1.1000,1.0950,1.0950,-100\n";
+
+	void testStatistics() {
+		std::string data = "Instrument,Lots,Open,Close,SL,Profit\n";
+		data += kWin;
+		data += kWin;
+		data += kLoss;
+		data += "USDJPY,0.1,110.00,110.50,109.50,45.45\n";
+
+		JournalReport report;
+		CHECK( JournalImporter( settings() ).importData( data, &report ) );
+		CHECK( report.error.empty() );
+		CHECK( report.skipped == 0 );
+		CHECK( report.total.trades == 4 );
+		CHECK( report.instruments.size() == 2 );
+
+		const JournalStats& eurusd = report.instruments["EURUSD"];
+		CHECK( eurusd.trades == 3 );
+		CHECK_NEAR( eurusd.expectancy(), 1.0 / 3, 1e-9 );
+		CHECK_NEAR( eurusd.winRate(), 2.0 / 3, 1e-12 );
+		CHECK_NEAR( eurusd.sizingDeviation(), 0, 1e-9 );
+		CHECK_NEAR( eurusd.commissionDrag(), 0, 1e-12 );
+	}
+
+	void testCommission() {
+		JournalSettings with_commission = settings();
+		with_commission.commission = 0.5;  // 20 micro lots: 20 * 0.5 * 2 = 20
+
+		JournalReport report;
+		CHECK( JournalImporter( with_commission ).importData( std::string( "instrument,lots,open,close,sl,profit\n" ) + kWin, &report ) );
+		CHECK_NEAR( report.total.commission, 20, 1e-9 );
+		CHECK_NEAR( report.total.commissionDrag(), 0.2, 1e-9 );
+		CHECK_NEAR( report.total.expectancy(), 0.8, 1e-9 );
+	}
+
+	void testNumberFormats() {
+		std::string data = "symbol,volume,open,close,sl,profit\n";
+		// quoted fields keep their delimiters, thousands separators and
+		// exponents are read
+		data += "\"EUR/USD\",\"0.2\",1.1000,1.1050,1.0950,\"1,000.00\"\n";
+		data += "EURUSD,2e-1,1.1000,1.1050,1.0950,1e2\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,+1E+2\n";
+		// malformed numbers skip the line
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,1e2.5\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,\"1e1,000\"\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,1e\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,e2\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,\"1,00\"\n";
+		data += "EURUSD,0.2,1.1000,1.1050,1.0950,\n";
+
+		JournalReport report;
+		CHECK( JournalImporter( settings() ).importData( data, &report ) );
+		CHECK( report.total.trades == 3 );
+		CHECK( report.skipped == 6 );
+		CHECK_NEAR( report.total.profit, 1200, 1e-9 );
+	}
+
+	void testSemicolons() {
+		std::string data = "instrument;lots;open;close;sl;profit\r\n";
+		data += "EURUSD;0.2;1.1000;1.1050;1.0950;100\r\n";
+
+		JournalReport report;
+		CHECK( JournalImporter( settings() ).importData( data, &report ) );
+		CHECK( report.total.trades == 1 );
+		CHECK_NEAR( report.total.expectancy(), 1, 1e-9 );
+	}
+
+	void testMissingColumns() {
+		JournalReport report;
+		CHECK( ! JournalImporter( settings() ).importData( "instrument,lots,open\nEURUSD,0.2,1.1\n", &report ) );
+		CHECK( ! report.error.empty() );
+	}
+
+	// a statement split over threads adds up to the same report
+	void testThreads() {
+		std::string data = "instrument,lots,open,close,sl,profit\n";
+		while ( data.size() < ( 4u << 20 ) ) {
+			data += kWin;
+			data += kLoss;
+			data += "GBPUSD,0.2,1.2500,1.2450,1.2450,-100\n";
+		}
+
+		JournalReport single, threaded;
+		CHECK( JournalImporter( settings() ).importData( data, &single, 1 ) );
+		CHECK( JournalImporter( settings() ).importData( data, &threaded, 4 ) );
+		CHECK( single.total.trades == threaded.total.trades );
+		CHECK( single.total.wins == threaded.total.wins );
+		CHECK( single.instruments.size() == threaded.instruments.size() );
+		CHECK_NEAR( single.total.r_sum, threaded.total.r_sum, 1e-6 );
+		CHECK( threaded.skipped == 0 );
+	}
+};
+
+int main() {
+	testStatistics();
+	testCommission();
+	testNumberFormats();
+	testSemicolons();
+	testMissingColumns();
+	testThreads();
+	return TEST_RESULT();
+}
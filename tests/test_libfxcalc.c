@@ -0,0 +1,141 @@
+/*
+ * License
+ * FXCalc is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FXCalc is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* The C interface of libfxcalc, compiled as C to keep the header C clean. */
+
+#include "libfxcalc.h"
+
+#include <math.h>
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK( expression ) \
+	do { \
+		if ( ! ( expression ) ) { \
+			printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expression ); \
+			++failures; \
+		} \
+	} while ( 0 )
+
+#define CHECK_NEAR( actual, expected, tolerance ) CHECK( fabs( ( actual ) - ( expected ) ) <= ( tolerance ) )
+
+static void testUnitCosts( void ) {
+	int32_t conversion[3] = { FXCALC_CONVERSION_NONE, FXCALC_CONVERSION_ASK, FXCALC_CONVERSION_BID };
+	uint8_t jpy[3]        = { 0, 1, 0 };
+	double rate[3]        = { 1.1, 110, 1.25 };
+	double unit_costs[3];
+
+	CHECK( fxcalc_unit_costs( 3, conversion, jpy, rate, unit_costs ) == FXCALC_OK );
+	CHECK_NEAR( unit_costs[0], 0.0001, 1e-15 );
+	CHECK_NEAR( unit_costs[1], 0.0001 / 1.1, 1e-15 );
+	CHECK_NEAR( unit_costs[2], 0.0001 * 1.25, 1e-15 );
+
+	conversion[1] = 3;
+	CHECK( fxcalc_unit_costs( 3, conversion, jpy, rate, unit_costs ) == FXCALC_ERROR_ARGUMENT );
+	conversion[1] = -1;
+	CHECK( fxcalc_unit_costs( 3, conversion, jpy, rate, unit_costs ) == FXCALC_ERROR_ARGUMENT );
+	CHECK( fxcalc_unit_costs( 3, NULL, jpy, rate, unit_costs ) == FXCALC_ERROR_ARGUMENT );
+}
+
+static void testSizing( void ) {
+	double balance[1]      = { 10000 };
+	double risk_percent[1] = { 1 };
+	double sl_pips[1]      = { 20 };
+	double unit_costs[1]   = { 0.0001 };
+	double units[1], lots[1], risk[1], margin[1], commission[1];
+	double margin_price[1] = { 1.1 };
+	double margin_ratio[1] = { 30 };
+	double commission_per_lot[1] = { 3.5 };
+
+	CHECK( fxcalc_position_size( 1, balance, risk_percent, sl_pips, unit_costs, units, lots, risk ) == FXCALC_OK );
+	CHECK_NEAR( risk[0], 100, 1e-9 );
+	CHECK_NEAR( units[0], 50000, 1e-6 );
+	CHECK_NEAR( lots[0], 0.5, 1e-12 );
+
+	/* unneeded outputs may be NULL */
+	CHECK( fxcalc_position_size( 1, balance, risk_percent, sl_pips, unit_costs, NULL, lots, NULL ) == FXCALC_OK );
+	CHECK( fxcalc_position_size( 1, NULL, risk_percent, sl_pips, unit_costs, units, lots, risk ) == FXCALC_ERROR_ARGUMENT );
+
+	CHECK( fxcalc_margin( 1, units, margin_price, margin_ratio, margin ) == FXCALC_OK );
+	CHECK_NEAR( margin[0], 50000 * 1.1 / 30, 1e-9 );
+
+	CHECK( fxcalc_commission( 1, lots, commission_per_lot, commission ) == FXCALC_OK );
+	CHECK_NEAR( commission[0], 350, 1e-9 );
+}
+
+static void testAllocateLots( void ) {
+	double target_risk[2]  = { 500, 60 };
+	double sl_pips[2]      = { 20, 20 };
+	double unit_costs[2]   = { 0.0001, 0.0001 };
+	double margin_price[2] = { 1.1, 1.1 };
+	double min_lot[2]      = { 0.01, 0.1 };
+	double lot_step[2]     = { 0.01, 0.1 };
+	double max_lot[2]      = { 0, 0 };
+	double lots[2], margin[2], total_risk, risk_bound;
+
+	CHECK( fxcalc_allocate_lots( 2, target_risk, sl_pips, unit_costs, margin_price, min_lot, lot_step, max_lot,
+		1e6, 30, lots, margin, &total_risk, &risk_bound ) == FXCALC_OK );
+	CHECK_NEAR( lots[0], 2.5, 1e-9 );
+	CHECK_NEAR( lots[1], 0.3, 1e-9 );
+	CHECK_NEAR( total_risk, 560, 1e-6 );
+	CHECK( total_risk <= risk_bound + 1e-6 );
+
+	lot_step[1] = 0;
+	CHECK( fxcalc_allocate_lots( 2, target_risk, sl_pips, unit_costs, margin_price, min_lot, lot_step, max_lot,
+		1e6, 30, lots, margin, &total_risk, &risk_bound ) == FXCALC_ERROR_ARGUMENT );
+	lot_step[1]     = 0.1;
+	margin_price[0] = 0;
+	CHECK( fxcalc_allocate_lots( 2, target_risk, sl_pips, unit_costs, margin_price, min_lot, lot_step, max_lot,
+		1e6, 30, lots, margin, &total_risk, &risk_bound ) == FXCALC_ERROR_ARGUMENT );
+	/* without a margin ratio the margin price isn't used */
+	CHECK( fxcalc_allocate_lots( 2, target_risk, sl_pips, unit_costs, margin_price, min_lot, lot_step, max_lot,
+		0, 0, lots, NULL, NULL, NULL ) == FXCALC_OK );
+}
+
+static void testStress( void ) {
+	/* EURUSD long on a USD account, currency 0 is USD, 1 is EUR */
+	uint32_t base[1]        = { 1 };
+	uint32_t quote[1]       = { 0 };
+	double units[1]         = { 100000 };
+	double price[1]         = { 1.1 };
+	double quote_rate[1]    = { 1 };
+	double margin_price[1]  = { 1.1 };
+	double margin_ratio[1]  = { 30 };
+	double shocks[4]        = { 0, 0.01, 0, -0.1 };
+	double equity[2];
+	uint8_t flags[2];
+
+	CHECK( fxcalc_stress( 1, base, quote, units, price, quote_rate, margin_price, margin_ratio,
+		2, 2, shocks, 4000, 100, 50, equity, NULL, NULL, flags, 1 ) == FXCALC_OK );
+	CHECK_NEAR( equity[0], 5100, 1e-9 );
+	CHECK( flags[0] == 0 );
+	CHECK( flags[1] == ( FXCALC_STRESS_MARGIN_CALL | FXCALC_STRESS_STOP_OUT ) );
+
+	/* currency indices must be below currency_count */
+	base[0] = 2;
+	CHECK( fxcalc_stress( 1, base, quote, units, price, quote_rate, margin_price, margin_ratio,
+		2, 2, shocks, 4000, 100, 50, equity, NULL, NULL, flags, 1 ) == FXCALC_ERROR_ARGUMENT );
+}
+
+int main( void ) {
+	CHECK( fxcalc_abi_version() == FXCALC_ABI_VERSION );
+	testUnitCosts();
+	testSizing();
+	testAllocateLots();
+	testStress();
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "stress.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace fxcalc;
+
+namespace {
+	// currency 0 is the account currency USD, 1 is EUR
+	StressTest eurusdLong() {
+		StressTest stress( 2 );
+		stress.addPosition( 1, 0, 100000, 1.1, 1, 1.1, 30 );
+		return stress;
+	}
+
+	void testScenarios() {
+		StressTest stress = eurusdLong();
+		CHECK_NEAR( stress.margin(), 110000 / 30.0, 1e-9 );
+
+		// no move, EUR +1 %, EUR -10 %
+		double shocks[] = { 0, 0, 0, 0.01, 0, -0.1 };
+		double equity[3], margin[3], level[3];
+		std::uint8_t flags[3];
+		stress.run( shocks, 3, 4000, 100, 50, equity, margin, level, flags, 1 );
+
+		CHECK_NEAR( equity[0], 4000, 1e-9 );
+		CHECK_NEAR( level[0], 4000 / ( 110000 / 30.0 ) * 100, 1e-9 );
+		CHECK( flags[0] == 0 );
+
+		CHECK_NEAR( equity[1], 4000 + 1100, 1e-9 );
+		CHECK_NEAR( margin[1], 110000 / 30.0 * 1.01, 1e-9 );
+		CHECK( flags[1] == 0 );
+
+		CHECK_NEAR( equity[2], 4000 - 11000, 1e-9 );
+		CHECK( flags[2] == ( kStressMarginCall | kStressStopOut ) );
+
+		// margin and levels are optional
+		stress.run( shocks, 3, 4000, 100, 50, equity, nullptr, nullptr, flags, 1 );
+		CHECK_NEAR( equity[1], 5100, 1e-9 );
+	}
+
+	void testOffsettingPositions() {
+		StressTest stress = eurusdLong();
+		stress.addPosition( 1, 0, -100000, 1.1, 1, 1.1, 30 );
+		// out of range currencies are ignored
+		stress.addPosition( 2, 0, 100000, 1.1, 1, 1.1, 30 );
+
+		double shocks[] = { 0, 0.05 };
+		double equity[1];
+		std::uint8_t flags[1];
+		stress.run( shocks, 1, 1000, 100, 50, equity, nullptr, nullptr, flags, 1 );
+		CHECK_NEAR( equity[0], 1000, 1e-9 );
+
+		stress.clear();
+		CHECK( stress.margin() == 0 );
+	}
+
+	// a threaded run gives the same results as a single threaded one
+	void testThreads() {
+		StressTest stress = eurusdLong();
+		const std::size_t scenarios = 200000;
+		std::vector<double> shocks( scenarios * 2 );
+		for ( std::size_t s = 0; s < scenarios; ++s ) {
+			shocks[s * 2 + 1] = std::sin( s * 0.37 ) * 0.05;
+		}
+
+		std::vector<double> single( scenarios ), threaded( scenarios );
+		std::vector<std::uint8_t> single_flags( scenarios ), threaded_flags( scenarios );
+		stress.run( shocks.data(), scenarios, 4000, 100, 50, single.data(), nullptr, nullptr, single_flags.data(), 1 );
+		stress.run( shocks.data(), scenarios, 4000, 100, 50, threaded.data(), nullptr, nullptr, threaded_flags.data(), 4 );
+		CHECK( single == threaded );
+		CHECK( single_flags == threaded_flags );
+	}
+};
+
+int main() {
+	testScenarios();
+	testOffsettingPositions();
+	testThreads();
+	return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include "check.h"
+#include "tradehistory.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace fxcalc;
+
+namespace {
+	// log terminal wealth of risking f of equity on the largest loss
+	double logWealth( const std::vector<double>& outcomes, double largest_loss, double f ) {
+		double sum = 0;
+		for ( double x : outcomes ) {
+			sum += std::log( 1 + f * x / largest_loss );
+		}
+		return sum;
+	}
+
+	void testKelly() {
+		// average win 2 R, average loss 1 R
+		TradeHistory history;
+		history.setOutcomes( { 2, -1, 2, -1, 0 } );
+		CHECK( history.size() == 5 );
+		CHECK( history.hasLosses() );
+		// W = 0.4, the break even trade counts as a trade but not as a win
+		CHECK_NEAR( history.kellyRisk(), 0.4 - 0.6 / 2, 1e-12 );
+
+		history.setOutcomes( { 3, -1, -1 } );
+		CHECK_NEAR( history.kellyRisk(), 1.0 / 3 - ( 2.0 / 3 ) / 3, 1e-12 );
+
+		// no edge is no risk, not a negative one
+		history.setOutcomes( { 1, -1, -1 } );
+		CHECK( history.kellyRisk() == 0 );
+	}
+
+	void testWithoutLosses() {
+		TradeHistory history;
+		CHECK( history.kellyRisk() == 0 );
+		CHECK( history.optimalFRisk() == 0 );
+
+		history.setOutcomes( { 1, 2, 0.5 } );
+		CHECK( ! history.hasLosses() );
+		CHECK( history.kellyRisk() == 0 );
+		CHECK( history.optimalFRisk() == 0 );
+
+		// losing history, f = 0 is the best
+		history.setOutcomes( { 1, -2, 0.5 } );
+		CHECK( history.optimalFRisk() == 0 );
+	}
+
+	void testOptimalF() {
+		std::vector<double> outcomes = { 2.5, -1, 1.2, -0.5, -1, 3, -2, 0.8, -1, 1.5 };
+		TradeHistory history;
+		history.setOutcomes( outcomes );
+		double f = history.optimalFRisk( 1 ) * 2;
+
+		// brute force over f, the largest loss is 2 R
+		double best = 0;
+		double best_wealth = 0;
+		for ( int i = 1; i < 100000; ++i ) {
+			double candidate = i / 100000.0;
+			double wealth = logWealth( outcomes, 2, candidate );
+			if ( wealth > best_wealth ) {
+				best_wealth = wealth;
+				best = candidate;
+			}
+		}
+		CHECK( best > 0 );
+		CHECK_NEAR( f, best, 1e-4 );
+		CHECK( logWealth( outcomes, 2, f ) >= best_wealth - 1e-8 );
+	}
+
+	void testThreads() {
+		// enough outcomes for several threads
+		std::vector<double> outcomes;
+		for ( int i = 0; i < 300000; ++i ) {
+			outcomes.push_back( i % 3 == 0 ? -1 - ( i % 7 ) * 0.1 : 0.4 + ( i % 11 ) * 0.1 );
+		}
+		TradeHistory history;
+		history.setOutcomes( outcomes );
+		double single = history.optimalFRisk( 1 );
+		CHECK( single > 0 );
+		CHECK_NEAR( history.optimalFRisk( 4 ), single, 1e-9 );
+		CHECK_NEAR( history.optimalFRisk( 0 ), single, 1e-9 );
+	}
+}
+
+int main() {
+	testKelly();
+	testWithoutLosses();
+	testOptimalF();
+	testThreads();
+	return TEST_RESULT();
+}
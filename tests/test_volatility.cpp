@@ -0,0 +1,88 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "volatility.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace fxcalc;
+
+namespace {
+	void testRollingWindow() {
+		RollingWindow window( 3 );
+		std::size_t a = window.addSeries();
+		std::size_t b = window.addSeries();
+
+		window.push( a, 1 );
+		window.push( a, 2 );
+		CHECK( ! window.full( a ) );
+		CHECK_NEAR( window.mean( a ), 1.5, 1e-12 );
+		window.push( a, 3 );
+		window.push( a, 4 );
+		CHECK( window.full( a ) );
+		CHECK_NEAR( window.mean( a ), 3, 1e-12 );
+		CHECK_NEAR( window.stddev( a ), 1, 1e-12 );
+
+		// series don't share values
+		CHECK( ! window.full( b ) );
+		CHECK_NEAR( window.mean( b ), 0, 1e-12 );
+	}
+
+	// the running sums must not drift away from the window on long feeds
+	void testNoDrift() {
+		const std::size_t period = 14;
+		RollingWindow window( period );
+		std::size_t series = window.addSeries();
+
+		for ( std::size_t i = 0; i < period * 70000; ++i ) {
+			// large and tiny values alternate, the worst case for cancellation
+			window.push( series, i % 2 == 0 ? 1e6 + i * 1e-3 : 1e-6 * i );
+		}
+		// a quiet market after a volatile one, a full period later the
+		// sums hold nothing of the volatile values
+		for ( std::size_t i = 0; i < period; ++i ) {
+			window.push( series, 0.0001 );
+		}
+
+		CHECK_NEAR( window.mean( series ), 0.0001, 1e-15 );
+		CHECK_NEAR( window.stddev( series ), 0, 1e-12 );
+	}
+
+	void testAverageTrueRange() {
+		VolatilityEngine engine( 2 );
+		std::size_t eurusd = engine.addInstrument( 0.0001 );
+
+		engine.addBar( eurusd, 1.1010, 1.1000, 1.1005 );
+		CHECK( ! engine.ready( eurusd ) );
+		// gap up, true range reaches down to the previous close
+		engine.addBar( eurusd, 1.1030, 1.1020, 1.1025 );
+		CHECK( engine.ready( eurusd ) );
+		CHECK_NEAR( engine.atrPips( eurusd ), ( 10 + 25 ) / 2.0, 1e-6 );
+
+		engine.addBar( eurusd, 1.1040, 1.1020, 1.1035 );
+		CHECK_NEAR( engine.atrPips( eurusd ), ( 25 + 20 ) / 2.0, 1e-6 );
+		// close to close changes of 20 and 10 pips
+		CHECK_NEAR( engine.stddevPips( eurusd ), std::sqrt( 50.0 ), 1e-6 );
+	}
+};
+
+int main() {
+	testRollingWindow();
+	testNoDrift();
+	testAverageTrueRange();
+	return TEST_RESULT();
+}
@@ -0,0 +1,104 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "check.h"
+#include "watchlist.h"
+
+#include <QCoreApplication>
+#include <QModelIndex>
+#include <QVector>
+
+#include <set>
+#include <utility>
+
+using namespace fxcalc;
+
+namespace {
+	typedef std::set<std::pair<int, int>> Cells;
+
+	// cells covered by the dataChanged signals of one flush
+	Cells flush( WatchlistModel* model ) {
+		Cells cells;
+		QMetaObject::Connection connection = QObject::connect( model, &WatchlistModel::dataChanged,
+			[&cells]( const QModelIndex& top_left, const QModelIndex& bottom_right ) {
+				for ( int row = top_left.row(); row <= bottom_right.row(); ++row ) {
+					for ( int column = top_left.column(); column <= bottom_right.column(); ++column ) {
+						CHECK( cells.insert( std::make_pair( row, column ) ).second );
+					}
+				}
+			});
+		QMetaObject::invokeMethod( model, "flush", Qt::DirectConnection );
+		QObject::disconnect( connection );
+		return cells;
+	}
+
+	Cells columns( int row, int first, int last ) {
+		Cells cells;
+		for ( int column = first; column <= last; ++column ) {
+			cells.insert( std::make_pair( row, column ) );
+		}
+		return cells;
+	}
+
+	void testChangedCells() {
+		std::map<QString, int> priority = { { "EUR", 10 }, { "GBP", 20 }, { "AUD", 30 }, { "USD", 50 }, { "JPY", 90 } };
+		WatchlistModel model( priority );
+		model.setInstruments( QStringList() << "EURUSD" << "GBPUSD" << "AUDUSD" << "USDJPY" );
+		model.setRate( "EURUSD", 1.10 );
+		model.setRate( "GBPUSD", 1.25 );
+		model.setRate( "AUDUSD", 0.70 );
+		model.setRate( "USDJPY", 110 );
+		model.setInputs( 10000, 1, 20, 30, "USD" );
+		flush( &model );
+
+		// a new EURUSD price only moves the EURUSD margin
+		model.setRate( "EURUSD", 1.11 );
+		CHECK( flush( &model ) == columns( 0, WatchlistModel::MARGIN, WatchlistModel::MARGIN ) );
+
+		// rows with a gap between them are reported separately, the row
+		// in between isn't touched
+		model.setRate( "EURUSD", 1.12 );
+		model.setRate( "AUDUSD", 0.71 );
+		Cells expected = columns( 0, WatchlistModel::MARGIN, WatchlistModel::MARGIN );
+		Cells row_2    = columns( 2, WatchlistModel::MARGIN, WatchlistModel::MARGIN );
+		expected.insert( row_2.begin(), row_2.end() );
+		CHECK( flush( &model ) == expected );
+
+		// USDJPY converts its pip value with its own price
+		model.setRate( "USDJPY", 111 );
+		CHECK( flush( &model ) == columns( 3, WatchlistModel::UNITS, WatchlistModel::MARGIN ) );
+
+		// a new stop changes units, lots and margin of every row but no
+		// pip value, the unchanged column in the middle stays unreported
+		model.setInputs( 10000, 1, 25, 30, "USD" );
+		expected.clear();
+		for ( int row = 0; row < 4; ++row ) {
+			Cells cells = columns( row, WatchlistModel::UNITS, WatchlistModel::LOTS );
+			expected.insert( cells.begin(), cells.end() );
+			expected.insert( std::make_pair( row, static_cast<int>( WatchlistModel::MARGIN ) ) );
+		}
+		CHECK( flush( &model ) == expected );
+
+		// nothing changed, nothing reported
+		model.setRate( "GBPUSD", 1.25 );
+		CHECK( flush( &model ).empty() );
+	}
+};
+
+int main( int argc, char* argv[] ) {
+	QCoreApplication app( argc, argv );
+	testChangedCells();
+	return TEST_RESULT();
+}
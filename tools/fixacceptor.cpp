@@ -0,0 +1,198 @@
+// License
+// FXCalc is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// FXCalc is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with FXCalc. If not, see <http://www.gnu.org/licenses/>.
+
+// Local FIX 4.4 acceptor stand-in for the order ticket. Answers logons and
+// fills every NewOrderSingle with an ExecutionReport.
+//
+// usage: fixacceptor [port]
+//        fixacceptor --bench [orders]   acceptor and client in one process,
+//                                       prints throughput and latency
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "fixencoder.h"
+#include "ordersession.h"
+
+namespace fxcalc {
+	class FixAcceptor: public QObject {
+	public:
+		FixAcceptor(QObject* parent = 0): QObject(parent), encoder_("BROKER", "FXCALC"), seq_num_(1), messages_(0) {
+			connect( &server_, &QTcpServer::newConnection, this, [this]() {
+				while ( server_.hasPendingConnections() ) {
+					QTcpSocket* socket = server_.nextPendingConnection();
+					socket->setSocketOption( QAbstractSocket::LowDelayOption, 1 );
+					connect( socket, &QTcpSocket::readyRead, this, [this, socket]() { read( socket ); } );
+					connect( socket, &QTcpSocket::disconnected, this, [this, socket]() {
+						buffers_.erase( socket );
+						socket->deleteLater();
+					});
+				}
+			});
+		}
+
+		bool listen( quint16 port ) {
+			return server_.listen( QHostAddress::LocalHost, port );
+		}
+
+		quint16 port() const {
+			return server_.serverPort();
+		}
+
+		// messages since the last call
+		quint64 takeMessages() {
+			quint64 result = messages_;
+			messages_ = 0;
+			return result;
+		}
+
+	private:
+		void read( QTcpSocket* socket ) {
+			QByteArray& buffer = buffers_[socket];
+			buffer.append( socket->readAll() );
+
+			int offset = 0;
+			std::size_t length = 0;
+			while ( true ) {
+				offset += static_cast<int>( FixEncoder::garbageLength( buffer.constData() + offset, buffer.size() - offset ) );
+				length = FixEncoder::messageLength( buffer.constData() + offset, buffer.size() - offset );
+				if ( length == 0 ) break;
+				reply( socket, buffer.constData() + offset, length );
+				offset += static_cast<int>( length );
+				++messages_;
+			}
+			buffer.remove( 0, offset );
+		}
+
+		void reply( QTcpSocket* socket, const char* message, std::size_t length ) {
+			const char* type = nullptr;
+			std::size_t type_length = 0;
+			if ( ! FixEncoder::field( message, length, "35", &type, &type_length ) || type_length != 1 ) return;
+
+			std::int64_t now = QDateTime::currentMSecsSinceEpoch();
+			if ( *type == 'A' ) {
+				// a reset request is confirmed with a reset logon
+				const char* reset = nullptr;
+				std::size_t reset_length = 0;
+				bool reset_seq_num = FixEncoder::field( message, length, "141", &reset, &reset_length )
+					&& reset_length == 1 && *reset == 'Y';
+				if ( reset_seq_num ) {
+					seq_num_ = 1;
+				}
+				socket->write( encoder_.data(), encoder_.logon( seq_num_++, 30, reset_seq_num, now ) );
+			} else if ( *type == '5' ) {
+				socket->write( encoder_.data(), encoder_.logout( seq_num_++, now ) );
+				socket->disconnectFromHost();
+			} else if ( *type == 'D' ) {
+				const char* cl_ord_id = nullptr;
+				const char* symbol    = nullptr;
+				const char* side      = nullptr;
+				const char* quantity  = nullptr;
+				std::size_t cl_ord_id_length = 0, symbol_length = 0, side_length = 0, quantity_length = 0;
+				if ( ! FixEncoder::field( message, length, "11", &cl_ord_id, &cl_ord_id_length )
+					|| ! FixEncoder::field( message, length, "55", &symbol, &symbol_length )
+					|| ! FixEncoder::field( message, length, "54", &side, &side_length )
+					|| ! FixEncoder::field( message, length, "38", &quantity, &quantity_length ) ) {
+					return;
+				}
+
+				std::int64_t units = 0;
+				for ( std::size_t i = 0; i < quantity_length && quantity[i] >= '0' && quantity[i] <= '9'; ++i ) {
+					units = units * 10 + ( quantity[i] - '0' );
+				}
+				socket->write( encoder_.data(), encoder_.executionReport( seq_num_++, cl_ord_id, cl_ord_id_length,
+					symbol, symbol_length, *side, units, now ) );
+			}
+		}
+
+		QTcpServer server_;
+		FixEncoder encoder_;
+		std::uint32_t seq_num_;
+		quint64 messages_;
+		std::map<QTcpSocket*, QByteArray> buffers_;
+	};
+};
+
+using namespace fxcalc;
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+
+	QStringList args = app.arguments();
+	bool bench = args.size() > 1 && args[1] == "--bench";
+
+	FixAcceptor acceptor;
+	quint16 port = bench ? 0 : 9878;
+	if ( ! bench && args.size() > 1 ) {
+		port = args[1].toUShort();
+	}
+	if ( ! acceptor.listen( port ) ) {
+		out << "Couldn't listen on port " << port << endl;
+		return 1;
+	}
+
+	if ( ! bench ) {
+		out << "FIX acceptor listening on 127.0.0.1:" << acceptor.port() << endl;
+
+		QTimer report;
+		QObject::connect( &report, &QTimer::timeout, [&]() {
+			quint64 messages = acceptor.takeMessages();
+			if ( messages > 0 ) {
+				out << messages << " msg/s" << endl;
+			}
+		});
+		report.start( 1000 );
+		return app.exec();
+	}
+
+	// benchmark: send orders one after another, each after the previous fill
+	int orders = args.size() > 2 ? std::max( 1, args[2].toInt() ) : 100000;
+	std::vector<double> latencies;
+	latencies.reserve( orders );
+	QElapsedTimer elapsed;
+
+	OrderSession session;
+	QObject::connect( &session, &OrderSession::loggedOn, [&]() {
+		elapsed.start();
+		session.sendOrder( "EURUSD", FixEncoder::BUY, 100000 );
+	});
+	QObject::connect( &session, &OrderSession::orderFilled, [&]( std::uint64_t, double latency_ms ) {
+		latencies.push_back( latency_ms );
+		if ( static_cast<int>( latencies.size() ) < orders ) {
+			session.sendOrder( "EURUSD", FixEncoder::BUY, 100000 );
+			return;
+		}
+
+		double seconds = elapsed.nsecsElapsed() / 1e9;
+		std::sort( latencies.begin(), latencies.end() );
+		out << orders << " orders in " << seconds << " s, " << orders / seconds << " orders/s" << endl;
+		out << "round trip p50 " << latencies[latencies.size() / 2] * 1000 << " us, p99 "
+			<< latencies[latencies.size() * 99 / 100] * 1000 << " us" << endl;
+		app.quit();
+	});
+	session.open( QString("127.0.0.1:%1").arg( acceptor.port() ), "FXCALC", "BROKER" );
+
+	return app.exec();
+}